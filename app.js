@@ -11,6 +11,25 @@ let avlTree = null;
 let graph = null;
 let hashTable = null;
 
+// Dirty-region rendering: what is currently on the canvas, so small changes
+// reported by the C++ structures (getChanges) can be repainted in place
+let renderedDS = null;
+let heapRenderedLength = 0;
+let graphRenderedKey = '';
+// Parsed matrix and edge list of the current graph, see getGraphSnapshot()
+let graphSnapshot = null;
+// Buckets of the hash table as last drawn, patched by partial repaints
+let hashBuckets = null;
+
+// Background worker for heavy operations (see worker.js)
+let dsWorker = null;
+let dsWorkerNextId = 0;
+const dsWorkerPending = new Map();
+let dsWorkerReadyTimer = null;
+// Graph object and revision the worker's mirror graph was last loaded from
+let dsWorkerGraph = null;
+let dsWorkerGraphRevision = -1;
+
 // Initialize the application
 window.onload = function() {
     console.log('Initializing application...');
@@ -32,6 +51,7 @@ window.onload = function() {
     // Set up event listeners
     setupEventListeners();
     setupHeapTypeToggle();
+    setupWorker();
     
     // The data_structures.js script loads and initializes immediately
     setTimeout(checkWasmExports, 100);
@@ -74,6 +94,204 @@ function checkWasmExports() {
     }
 }
 
+// Start the background worker; operations fall back to the main thread without it
+function setupWorker() {
+    if (typeof Worker === 'undefined') {
+        return;
+    }
+    
+    try {
+        dsWorker = new Worker('worker.js');
+    } catch (error) {
+        console.log('Worker unavailable, running operations on the main thread:', error);
+        dsWorker = null;
+        return;
+    }
+    
+    // A worker whose WebAssembly never initializes would leave requests
+    // pending forever, so give up on it after a while
+    dsWorkerReadyTimer = setTimeout(() => disableWorker('did not start in time'), 10000);
+    
+    dsWorker.onmessage = function(event) {
+        const { id, result, error, ready, failed } = event.data;
+        if (ready) {
+            clearTimeout(dsWorkerReadyTimer);
+            return;
+        }
+        if (failed) {
+            disableWorker(failed);
+            return;
+        }
+        
+        const pending = dsWorkerPending.get(id);
+        if (!pending) return;
+        dsWorkerPending.delete(id);
+        if (error) {
+            // The mirror graph may not match after a failed request
+            dsWorkerGraph = null;
+            pending.reject(new Error(error));
+        } else {
+            pending.resolve(result);
+        }
+    };
+    
+    dsWorker.onerror = function(event) {
+        disableWorker(event.message);
+    };
+}
+
+// Stops using the worker and reruns its pending operations on the main thread
+function disableWorker(reason) {
+    if (!dsWorker) return;
+    console.error('Worker failed, running operations on the main thread:', reason);
+    clearTimeout(dsWorkerReadyTimer);
+    dsWorker.terminate();
+    dsWorker = null;
+    dsWorkerGraph = null;
+    dsWorkerPending.forEach(pending => pending.retry());
+    dsWorkerPending.clear();
+}
+
+// Run an operation in the worker, or call fallback() on the main thread if it is unavailable
+function runInWorker(op, args, fallback, transfer = []) {
+    if (!dsWorker) {
+        return new Promise(resolve => resolve(fallback()));
+    }
+    
+    return new Promise((resolve, reject) => {
+        const id = dsWorkerNextId++;
+        dsWorkerPending.set(id, {
+            resolve,
+            reject,
+            retry: () => {
+                try {
+                    resolve(fallback());
+                } catch (error) {
+                    reject(error);
+                }
+            }
+        });
+        dsWorker.postMessage({ id, op, args }, transfer);
+    });
+}
+
+// Run bfs/dfs/dijkstra/prim in the worker's mirror of the current graph.
+// The matrix is only sent (as a transferred Int32Array) when the graph
+// changed since the last run.
+// Resolves to { result, trace } (see runTracedAlgorithm()), or to null
+// when the graph was replaced or deleted before the run finished
+function runGraphAlgorithm(algorithm, start) {
+    const currentGraph = graph;
+    const isCurrent = () => graph === currentGraph;
+    
+    // May run later, after the worker failed, when currentGraph is gone
+    const fallback = () => isCurrent() ? runTracedAlgorithm(currentGraph, algorithm, start) : null;
+    
+    if (!dsWorker || !currentGraph.copyWeights || !currentGraph.getRevision) {
+        return new Promise(resolve => resolve(fallback()));
+    }
+    
+    const args = { algorithm, start };
+    const transfer = [];
+    const revision = currentGraph.getRevision();
+    if (dsWorkerGraph !== currentGraph || dsWorkerGraphRevision !== revision) {
+        const vertices = currentGraph.getVertexCount();
+        const weights = new Int32Array(vertices * vertices);
+        currentGraph.copyWeights(weights);
+        args.weights = weights;
+        args.vertices = vertices;
+        args.directed = currentGraph.getIsDirected();
+        transfer.push(weights.buffer);
+        dsWorkerGraph = currentGraph;
+        dsWorkerGraphRevision = revision;
+    }
+    return runInWorker('graphAlgorithm', args, fallback, transfer)
+        .then(run => isCurrent() ? run : null,
+              error => isCurrent() ? Promise.reject(error) : null);
+}
+
+// Trace events kept per run, matching GRAPH_TRACE_CAPACITY in worker.js
+const GRAPH_TRACE_CAPACITY = 4096;
+
+// Runs one of bfs/dfs/dijkstra/prim on g with tracing enabled. trace is
+// a copy of the events, or null when the module has no trace API or the
+// run overflowed the capacity.
+function runTracedAlgorithm(g, algorithm, start) {
+    const traced = g.enableTrace ? g.enableTrace(GRAPH_TRACE_CAPACITY) : false;
+    try {
+        let result;
+        switch (algorithm) {
+            case 'bfs': result = g.bfs(start); break;
+            case 'dfs': result = g.dfs(start); break;
+            case 'dijkstra': result = g.dijkstra(start); break;
+            case 'prim': result = g.primMST(); break;
+        }
+        const trace = traced && g.getTraceDropped() === 0 ? g.getTrace().slice() : null;
+        return { result, trace };
+    } finally {
+        if (traced) g.disableTrace();
+    }
+}
+
+// Event types from TraceEvent in data_structures.cpp; events are 4 ints
+const TRACE_VISIT = 1;
+const TRACE_SETTLE = 4;
+
+// Highlight order taken from a trace: visited vertices for bfs/dfs,
+// settled vertices for dijkstra and parent/vertex pairs for prim
+function graphTracePath(algorithm, trace) {
+    const path = [];
+    for (let i = 0; i + 3 < trace.length; i += 4) {
+        const type = trace[i], vertex = trace[i + 1], parent = trace[i + 3];
+        if (type === TRACE_VISIT && (algorithm === 'bfs' || algorithm === 'dfs')) {
+            path.push(vertex);
+        } else if (type === TRACE_SETTLE && algorithm === 'dijkstra') {
+            path.push(vertex);
+        } else if (type === TRACE_SETTLE && algorithm === 'prim' && parent >= 0) {
+            path.push(parent, vertex);
+        }
+    }
+    return path;
+}
+
+// Steps the highlight through a traced run, one event per tick
+const GRAPH_TRACE_STEP_MS = 250;
+let graphTraceTimer = null;
+
+function animateGraphPath(algorithm, path) {
+    clearGraphHighlight();
+    currentGraphType = algorithm;
+    const stride = algorithm === 'prim' ? 2 : 1;
+    let shown = 0;
+    const step = () => {
+        shown = Math.min(shown + stride, path.length);
+        currentGraphPath = path.slice(0, shown);
+        graphTraceTimer = shown < path.length ? setTimeout(step, GRAPH_TRACE_STEP_MS) : null;
+        updateVisualization();
+    };
+    step();
+}
+
+// Shows a finished run: animated from its trace when there is one,
+// otherwise all at once from the path parsed out of the result string
+function showGraphRun(algorithm, trace, parsedPath) {
+    if (trace) {
+        animateGraphPath(algorithm, graphTracePath(algorithm, trace));
+    } else {
+        clearGraphHighlight();
+        currentGraphPath = parsedPath;
+        currentGraphType = algorithm;
+        updateVisualization();
+    }
+}
+
+function clearGraphHighlight() {
+    clearTimeout(graphTraceTimer);
+    graphTraceTimer = null;
+    currentGraphPath = [];
+    currentGraphType = '';
+}
+
 // Set up all event listeners
 function setupEventListeners() {
     // Binary Heap events
@@ -93,6 +311,7 @@ function setupEventListeners() {
     document.getElementById('add-vertex').addEventListener('click', addVertex);
     document.getElementById('remove-vertex').addEventListener('click', removeVertex);
     document.getElementById('clear-graph').addEventListener('click', clearGraph);
+    document.getElementById('import-graph').addEventListener('click', importGraph);
     document.getElementById('run-bfs').addEventListener('click', runBFS);
     document.getElementById('run-dfs').addEventListener('click', runDFS);
     document.getElementById('run-dijkstra').addEventListener('click', runDijkstra);
@@ -285,7 +504,13 @@ function insertHeap() {
     }
     
     try {
-        binaryHeap.insert(value);
+        if (binaryHeap.insert(value) === false) {
+            const reason = binaryHeap.getBound() > 0 && binaryHeap.getSize() === binaryHeap.getBound()
+                ? 'it does not beat the root of the bounded heap'
+                : 'heap is full or memory budget exceeded';
+            logMessage(`Could not insert ${value}: ${reason}`, 'error');
+            return;
+        }
         logMessage(`Inserted ${value} into Binary Heap`, 'success');
         updateStateDisplays();
         updateVisualization();
@@ -383,7 +608,10 @@ function insertAVL() {
     }
     
     try {
-        avlTree.insert(value);
+        if (avlTree.insert(value) === false) {
+            logMessage(`Could not insert ${value}: memory budget exceeded`, 'error');
+            return;
+        }
         const rotation = avlTree.getLastRotation ? avlTree.getLastRotation() : "Rotation info not available";
         logMessage(`Inserted ${value} into AVL Tree - ${rotation}`, 'success');
         updateStateDisplays();
@@ -453,8 +681,7 @@ function initGraph() {
         
         // Create new graph with directed flag
         graph = new Module.Graph(nodeCount, graphIsDirected);
-        currentGraphPath = [];
-        currentGraphType = '';
+        clearGraphHighlight();
         logMessage(`Graph initialized with ${nodeCount} nodes (${graphIsDirected ? 'directed' : 'undirected'})`, 'success');
         updateVisualization();
     } catch (error) {
@@ -702,8 +929,7 @@ function clearGraph() {
         // Completely remove the graph
         if (graph.delete) graph.delete();
         graph = null;
-        currentGraphPath = [];
-        currentGraphType = '';
+        clearGraphHighlight();
         document.getElementById('graph-nodes').value = 6; // Reset to default
         document.getElementById('graph-result').textContent = '-';
         logMessage('Graph completely removed from display', 'info');
@@ -713,7 +939,53 @@ function clearGraph() {
     }
 }
 
-function runBFS() {
+// Stream an edge list or DIMACS .gr file into a new graph chunk by chunk
+async function importGraph() {
+    const file = document.getElementById('graph-file').files[0];
+    if (!file) {
+        logMessage('Please choose an edge list or DIMACS file to import', 'error');
+        return;
+    }
+    
+    let newGraph = null;
+    try {
+        newGraph = new Module.Graph(0, graphIsDirected);
+        if (!newGraph.beginImport) {
+            throw new Error('this build of data_structures.wasm has no streaming import; rebuild it with emcc');
+        }
+        newGraph.beginImport();
+        
+        const reader = file.stream().pipeThrough(new TextDecoderStream()).getReader();
+        while (true) {
+            const { done, value } = await reader.read();
+            if (done) break;
+            newGraph.importChunk(value);
+        }
+        
+        const [edges, rejected] = newGraph.endImport().slice(1, -1).split(',').map(Number);
+        
+        if (graph && graph.delete) {
+            graph.delete();
+        }
+        graph = newGraph;
+        clearGraphHighlight();
+        
+        const nodeCount = graph.getVertexCount();
+        logMessage(`Imported ${edges} edges into ${nodeCount} vertices from ${file.name}` +
+            (rejected > 0 ? ` (${rejected} lines rejected)` : ''), rejected > 0 ? 'warning' : 'success');
+        if (nodeCount > 15) {
+            logMessage('Graph is larger than 15 nodes; visualization may be crowded', 'warning');
+        }
+        updateVisualization();
+    } catch (error) {
+        if (newGraph && newGraph !== graph && newGraph.delete) {
+            newGraph.delete();
+        }
+        logMessage(`Error importing graph: ${error.message}`, 'error');
+    }
+}
+
+async function runBFS() {
     if (!graph) {
         logMessage('Graph not initialized. Please initialize graph first.', 'error');
         return;
@@ -733,21 +1005,23 @@ function runBFS() {
     }
     
     try {
-        const result = graph.bfs(start);
+        const run = await runGraphAlgorithm('bfs', start);
+        if (!run) {
+            logMessage(`Graph changed before BFS finished; result discarded`, 'info');
+            return;
+        }
+        const { result, trace } = run;
         document.getElementById('graph-result').textContent = result;
+        logMessage(`BFS traversal: ${result}`, 'success');
         
         // Parse BFS result for path highlighting
-        currentGraphPath = result.slice(1, -1).split(',').map(Number).filter(n => !isNaN(n));
-        currentGraphType = 'bfs';
-        
-        logMessage(`BFS traversal: ${result}`, 'success');
-        updateVisualization();
+        showGraphRun('bfs', trace, result.slice(1, -1).split(',').map(Number).filter(n => !isNaN(n)));
     } catch (error) {
         logMessage(`Error: ${error.message}`, 'error');
     }
 }
 
-function runDFS() {
+async function runDFS() {
     if (!graph) {
         logMessage('Graph not initialized. Please initialize graph first.', 'error');
         return;
@@ -767,21 +1041,23 @@ function runDFS() {
     }
     
     try {
-        const result = graph.dfs(start);
+        const run = await runGraphAlgorithm('dfs', start);
+        if (!run) {
+            logMessage(`Graph changed before DFS finished; result discarded`, 'info');
+            return;
+        }
+        const { result, trace } = run;
         document.getElementById('graph-result').textContent = result;
+        logMessage(`DFS traversal: ${result}`, 'success');
         
         // Parse DFS result for path highlighting
-        currentGraphPath = result.slice(1, -1).split(',').map(Number).filter(n => !isNaN(n));
-        currentGraphType = 'dfs';
-        
-        logMessage(`DFS traversal: ${result}`, 'success');
-        updateVisualization();
+        showGraphRun('dfs', trace, result.slice(1, -1).split(',').map(Number).filter(n => !isNaN(n)));
     } catch (error) {
         logMessage(`Error: ${error.message}`, 'error');
     }
 }
 
-function runDijkstra() {
+async function runDijkstra() {
     if (!graph) {
         logMessage('Graph not initialized. Please initialize graph first.', 'error');
         return;
@@ -801,23 +1077,25 @@ function runDijkstra() {
     }
     
     try {
-        const result = graph.dijkstra(start);
+        const run = await runGraphAlgorithm('dijkstra', start);
+        if (!run) {
+            logMessage(`Graph changed before Dijkstra finished; result discarded`, 'info');
+            return;
+        }
+        const { result, trace } = run;
         document.getElementById('graph-result').textContent = result;
+        logMessage(`Dijkstra distances: ${result}`, 'success');
         
         // For Dijkstra, we'll highlight all reachable nodes
         const distances = result.slice(1, -1).split(',').map(Number);
-        currentGraphPath = distances.map((dist, index) => dist < 999999 ? index : -1)
-                                  .filter(index => index !== -1);
-        currentGraphType = 'dijkstra';
-        
-        logMessage(`Dijkstra distances: ${result}`, 'success');
-        updateVisualization();
+        showGraphRun('dijkstra', trace, distances.map((dist, index) => dist < 999999 ? index : -1)
+                                                 .filter(index => index !== -1));
     } catch (error) {
         logMessage(`Error: ${error.message}`, 'error');
     }
 }
 
-function runPrim() {
+async function runPrim() {
     if (!graph) {
         logMessage('Graph not initialized. Please initialize graph first.', 'error');
         return;
@@ -835,21 +1113,24 @@ function runPrim() {
     }
     
     try {
-        const result = graph.primMST();
+        const run = await runGraphAlgorithm('prim');
+        if (!run) {
+            logMessage(`Graph changed before Prim's MST finished; result discarded`, 'info');
+            return;
+        }
+        const { result, trace } = run;
         document.getElementById('graph-result').textContent = result;
+        logMessage(`Prim's MST edges: ${result}`, 'success');
         
         // Parse MST edges for highlighting
         const edges = result.slice(1, -1).split(',').filter(edge => edge.trim() !== '');
-        currentGraphPath = [];
+        const path = [];
         edges.forEach(edge => {
             const [nodes, weight] = edge.split(':');
             const [u, v] = nodes.split('-').map(Number);
-            currentGraphPath.push(u, v);
+            path.push(u, v);
         });
-        currentGraphType = 'prim';
-        
-        logMessage(`Prim's MST edges: ${result}`, 'success');
-        updateVisualization();
+        showGraphRun('prim', trace, path);
     } catch (error) {
         logMessage(`Error: ${error.message}`, 'error');
     }
@@ -871,7 +1152,10 @@ function insertHash() {
     }
     
     try {
-        hashTable.insert(key, value);
+        if (hashTable.insert(key, value) === false) {
+            logMessage(`Could not insert key ${key}: memory budget exceeded`, 'error');
+            return;
+        }
         logMessage(`Inserted key ${key} with value ${value}`, 'success');
         updateStateDisplays();
         updateVisualization();
@@ -927,9 +1211,15 @@ function clearHash() {
 function updateVisualization() {
     const canvas = document.getElementById('mainCanvas');
     const ctx = canvas.getContext('2d');
-    ctx.clearRect(0, 0, canvas.width, canvas.height);
+    const changes = takeChanges(getCurrentStructure());
     
     try {
+        if (renderedDS === currentDS && changes && repaintChanges(ctx, changes)) {
+            return;
+        }
+        
+        ctx.clearRect(0, 0, canvas.width, canvas.height);
+        renderedDS = currentDS;
         switch(currentDS) {
             case 'binaryHeap':
                 visualizeBinaryHeap(ctx);
@@ -948,10 +1238,84 @@ function updateVisualization() {
         }
     } catch (error) {
         console.error('Visualization error:', error);
+        renderedDS = null;
+        ctx.clearRect(0, 0, canvas.width, canvas.height);
         drawDefaultVisualization(ctx);
     }
 }
 
+function getCurrentStructure() {
+    switch(currentDS) {
+        case 'binaryHeap': return binaryHeap;
+        case 'avlTree': return avlTree;
+        case 'graph': return graph;
+        case 'hashTable': return hashTable;
+        default: return null;
+    }
+}
+
+// Returns the items changed since the last frame, or null when the
+// structure asks for (or cannot report anything but) a full repaint
+function takeChanges(ds) {
+    if (!ds || !ds.getChanges || !ds.resetChanges) {
+        return null;
+    }
+    
+    const changes = ds.getChanges();
+    const items = changes[0] ? null : Array.from(changes.subarray(1));
+    ds.resetChanges();
+    return items;
+}
+
+// Returns false when the change cannot be repainted in place
+function repaintChanges(ctx, changes) {
+    switch(currentDS) {
+        case 'binaryHeap':
+            return repaintHeapChanges(ctx, changes);
+        case 'graph':
+            return repaintGraphChanges(ctx, changes);
+        case 'hashTable':
+            return repaintHashChanges(ctx, changes);
+        case 'avlTree':
+            // The layout depends on the whole in-order sequence, so any
+            // changed key redraws the tree; lookups change nothing
+            return changes.length === 0;
+        default:
+            return false;
+    }
+}
+
+// Clears the dirty rectangles and redraws, in order, every item whose
+// bounds touch one of them; items are { bounds, draw(ctx) }
+function repaintRegions(ctx, rects, items) {
+    ctx.save();
+    ctx.beginPath();
+    rects.forEach(r => ctx.rect(r.x, r.y, r.w, r.h));
+    ctx.clip();
+    rects.forEach(r => ctx.clearRect(r.x, r.y, r.w, r.h));
+    
+    items.forEach(item => {
+        if (rects.some(r => rectsIntersect(r, item.bounds))) {
+            item.draw(ctx);
+        }
+    });
+    ctx.restore();
+}
+
+function unionRects(a, b) {
+    const x = Math.min(a.x, b.x);
+    const y = Math.min(a.y, b.y);
+    return {
+        x, y,
+        w: Math.max(a.x + a.w, b.x + b.w) - x,
+        h: Math.max(a.y + a.h, b.y + b.h) - y
+    };
+}
+
+function rectsIntersect(a, b) {
+    return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
 function drawDefaultVisualization(ctx) {
     ctx.fillStyle = '#2d3748';
     ctx.font = 'bold 20px Arial';
@@ -983,71 +1347,17 @@ function visualizeBinaryHeap(ctx) {
         const heapStr = binaryHeap.getArray();
         const heapArray = heapStr.slice(1, -1).split(',').filter(x => x.trim() !== '').map(Number);
         
+        heapRenderedLength = 0;
         if (heapArray.length === 0) {
             ctx.fillText('Heap is empty', 400, 250);
             return;
         }
         
-        ctx.font = '16px Arial';
-        ctx.fillText(`Array: ${heapStr}`, 400, 80);
-        
-        const startX = 400;
-        const startY = 150;
-        const nodeRadius = 25;
-        const levelHeight = 80;
-        
-        for (let i = 0; i < heapArray.length; i++) {
-            const level = Math.floor(Math.log2(i + 1));
-            const nodesInLevel = Math.pow(2, level);
-            const positionInLevel = i + 1 - Math.pow(2, level);
-            const x = startX + (positionInLevel - nodesInLevel/2 + 0.5) * 100;
-            const y = startY + level * levelHeight;
-            
-            const leftChild = 2 * i + 1;
-            const rightChild = 2 * i + 2;
-            
-            if (leftChild < heapArray.length) {
-                const childLevel = Math.floor(Math.log2(leftChild + 1));
-                const childNodesInLevel = Math.pow(2, childLevel);
-                const childPositionInLevel = leftChild + 1 - Math.pow(2, childLevel);
-                const childX = startX + (childPositionInLevel - childNodesInLevel/2 + 0.5) * 100;
-                const childY = startY + childLevel * levelHeight;
-                
-                ctx.strokeStyle = '#4a5568';
-                ctx.lineWidth = 2;
-                ctx.beginPath();
-                ctx.moveTo(x, y + nodeRadius);
-                ctx.lineTo(childX, childY - nodeRadius);
-                ctx.stroke();
-            }
-            
-            if (rightChild < heapArray.length) {
-                const childLevel = Math.floor(Math.log2(rightChild + 1));
-                const childNodesInLevel = Math.pow(2, childLevel);
-                const childPositionInLevel = rightChild + 1 - Math.pow(2, childLevel);
-                const childX = startX + (childPositionInLevel - childNodesInLevel/2 + 0.5) * 100;
-                const childY = startY + childLevel * levelHeight;
-                
-                ctx.strokeStyle = '#4a5568';
-                ctx.lineWidth = 2;
-                ctx.beginPath();
-                ctx.moveTo(x, y + nodeRadius);
-                ctx.lineTo(childX, childY - nodeRadius);
-                ctx.stroke();
-            }
-            
-            // Green theme for binary heap
-            ctx.fillStyle = '#2e8b57';
-            ctx.beginPath();
-            ctx.arc(x, y, nodeRadius, 0, 2 * Math.PI);
-            ctx.fill();
-            
-            ctx.fillStyle = 'white';
-            ctx.font = 'bold 16px Arial';
-            ctx.textAlign = 'center';
-            ctx.textBaseline = 'middle';
-            ctx.fillText(heapArray[i].toString(), x, y);
+        drawHeapHeader(ctx, heapHeaderText(heapArray.length, i => heapArray[i]));
+        for (let i = 0; i < Math.min(heapArray.length, HEAP_VISIBLE_SLOTS); i++) {
+            drawHeapSlot(ctx, heapArray[i], i, heapArray.length);
         }
+        heapRenderedLength = heapArray.length;
         
     } catch (error) {
         console.error('Binary heap visualization error:', error);
@@ -1055,6 +1365,119 @@ function visualizeBinaryHeap(ctx) {
     }
 }
 
+const HEAP_NODE_RADIUS = 25;
+// Levels 0-4; deeper slots start below the 500px canvas and only show
+// as the edges drawn down to them
+const HEAP_VISIBLE_SLOTS = 31;
+// The header lists at most this many slots
+const HEAP_HEADER_SLOTS = 16;
+
+function heapSlotPosition(i) {
+    const level = Math.floor(Math.log2(i + 1));
+    const nodesInLevel = Math.pow(2, level);
+    const positionInLevel = i + 1 - nodesInLevel;
+    return {
+        x: 400 + (positionInLevel - nodesInLevel/2 + 0.5) * 100,
+        y: 150 + level * 80
+    };
+}
+
+// slotAt(i) returns the value in slot i
+function heapHeaderText(size, slotAt) {
+    const count = Math.min(size, HEAP_HEADER_SLOTS);
+    const values = [];
+    for (let i = 0; i < count; i++) {
+        values.push(slotAt(i));
+    }
+    return `[${values.join(',')}${size > count ? ',…' : ''}]`;
+}
+
+function drawHeapHeader(ctx, headerText) {
+    ctx.fillStyle = '#2d3748';
+    ctx.font = '16px Arial';
+    ctx.textAlign = 'center';
+    ctx.textBaseline = 'middle';
+    ctx.fillText(`Array: ${headerText}`, 400, 80);
+}
+
+// Draws slot i of a heap with size items and the edges down to its children
+function drawHeapSlot(ctx, value, i, size) {
+    const { x, y } = heapSlotPosition(i);
+    
+    for (const child of [2 * i + 1, 2 * i + 2]) {
+        if (child < size) {
+            const childPos = heapSlotPosition(child);
+            ctx.strokeStyle = '#4a5568';
+            ctx.lineWidth = 2;
+            ctx.beginPath();
+            ctx.moveTo(x, y + HEAP_NODE_RADIUS);
+            ctx.lineTo(childPos.x, childPos.y - HEAP_NODE_RADIUS);
+            ctx.stroke();
+        }
+    }
+    
+    // Green theme for binary heap
+    ctx.fillStyle = '#2e8b57';
+    ctx.beginPath();
+    ctx.arc(x, y, HEAP_NODE_RADIUS, 0, 2 * Math.PI);
+    ctx.fill();
+    
+    ctx.fillStyle = 'white';
+    ctx.font = 'bold 16px Arial';
+    ctx.textAlign = 'center';
+    ctx.textBaseline = 'middle';
+    ctx.fillText(value.toString(), x, y);
+}
+
+// Box around slot i, stretched to cover the slot at index "to" as well
+function heapSlotBounds(i, to) {
+    const a = heapSlotPosition(i);
+    const b = heapSlotPosition(to);
+    const pad = HEAP_NODE_RADIUS + 2;
+    const x = Math.min(a.x, b.x) - pad;
+    const y = Math.min(a.y, b.y) - pad;
+    return { x, y, w: Math.abs(a.x - b.x) + 2 * pad, h: Math.abs(a.y - b.y) + 2 * pad };
+}
+
+// Changes are slot indices whose value or presence changed. Only the
+// slots whose boxes touch a change are read back, one getSlot() each.
+function repaintHeapChanges(ctx, changes) {
+    if (!binaryHeap.getSize || !binaryHeap.getSlot) {
+        return false;
+    }
+    
+    const size = binaryHeap.getSize();
+    if (size === 0 || heapRenderedLength === 0) {
+        return false;
+    }
+    if (changes.length === 0) {
+        return true;
+    }
+    
+    // A changed slot also dirties the edge from its parent
+    const header = { x: 0, y: 60, w: 800, h: 35 };
+    const rects = [header];
+    new Set(changes).forEach(i => {
+        if (i < 2 * HEAP_VISIBLE_SLOTS + 1) {
+            rects.push(heapSlotBounds(i, i > 0 ? Math.floor((i - 1) / 2) : i));
+        }
+    });
+    
+    const items = [{ bounds: header, draw: c => drawHeapHeader(c, heapHeaderText(size, i => binaryHeap.getSlot(i))) }];
+    for (let i = 0; i < Math.min(size, HEAP_VISIBLE_SLOTS); i++) {
+        const left = Math.min(2 * i + 1, size - 1);
+        const right = Math.min(2 * i + 2, size - 1);
+        const bounds = unionRects(heapSlotBounds(i, left > i ? left : i), heapSlotBounds(i, right > i ? right : i));
+        if (rects.some(r => rectsIntersect(r, bounds))) {
+            items.push({ bounds, draw: c => drawHeapSlot(c, binaryHeap.getSlot(i), i, size) });
+        }
+    }
+    
+    repaintRegions(ctx, rects, items);
+    heapRenderedLength = size;
+    return true;
+}
+
 // AVL Tree Visualization
 function visualizeAVLTree(ctx) {
     ctx.fillStyle = '#2d3748';
@@ -1394,62 +1817,32 @@ function visualizeGraph(ctx) {
             return;
         }
         
-        let matrix = null;
-        let nodeCount = 0;
-        let isDirected = false;
-        
-        if (graph.getMatrix) {
-            const matrixStr = graph.getMatrix();
-            matrix = parseMatrix(matrixStr);
-            if (matrix) {
-                nodeCount = matrix.length;
-            }
-        }
-        
-        // Check if graph is directed
-        if (graph.getIsDirected && graph.getIsDirected()) {
-            isDirected = true;
-        }
+        const snapshot = getGraphSnapshot();
+        const matrix = snapshot ? snapshot.matrix : null;
+        const nodeCount = snapshot ? snapshot.nodeCount : 0;
+        const isDirected = snapshot ? snapshot.isDirected : !!(graph.getIsDirected && graph.getIsDirected());
         
         // Update the node count display
         document.getElementById('graph-nodes').value = nodeCount;
         
-        const centerX = 400;
-        const centerY = 250;
-        
-        // Adjust radius based on node count for better visualization
-        const baseRadius = 150;
-        const radius = Math.max(80, Math.min(baseRadius, baseRadius - (nodeCount - 6) * 10));
-        
-        const nodePositions = [];
-        for (let i = 0; i < nodeCount; i++) {
-            const angle = (2 * Math.PI * i) / nodeCount;
-            const x = centerX + radius * Math.cos(angle);
-            const y = centerY + radius * Math.sin(angle);
-            nodePositions.push({ x, y, index: i });
+        // Larger graphs use the force-directed layout computed in C++
+        let nodePositions = nodeCount > 15 ? getForceLayoutPositions(nodeCount) : null;
+        if (!nodePositions) {
+            nodePositions = getCircleLayoutPositions(nodeCount);
         }
         
-        if (matrix) {
-            drawGraphEdges(ctx, matrix, nodePositions, nodeCount, isDirected);
+        if (snapshot) {
+            drawGraphEdges(ctx, snapshot.edges, nodePositions, isDirected);
         }
         
         drawGraphNodes(ctx, nodePositions);
+        drawGraphInfo(ctx, nodeCount, isDirected);
         
-        // Show graph info
-        ctx.fillStyle = '#4a5568';
-        ctx.font = '14px Arial';
-        ctx.fillText(`Nodes: ${nodeCount} | Type: ${isDirected ? 'Directed' : 'Undirected'}`, 400, 80);
-        
-        if (currentGraphType) {
-            ctx.fillStyle = getGraphAlgorithmColor(currentGraphType);
-            ctx.fillText(`Current Algorithm: ${currentGraphType.toUpperCase()}`, 400, 100);
-        }
-        
-        if (!matrix || !hasEdges(matrix, nodeCount)) {
-            ctx.fillStyle = '#a0aec0';
-            ctx.font = '16px Arial';
-            ctx.fillText('No edges added. Use "Add Edge" to connect nodes.', 400, 450);
+        const edges = snapshot ? snapshot.edges.length > 0 : false;
+        if (!edges) {
+            drawGraphEmptyHint(ctx);
         }
+        graphRenderedKey = matrix && nodePositions.length <= 15 ? graphRenderKey(nodeCount, isDirected, edges) : '';
         
     } catch (error) {
         console.error('Graph visualization error:', error);
@@ -1457,36 +1850,234 @@ function visualizeGraph(ctx) {
     }
 }
 
-function drawGraphEdges(ctx, matrix, nodePositions, nodeCount, isDirected) {
-    ctx.save();
+// The matrix string is O(n^2) to build and parse, so it is only re-read
+// when the graph object or its revision changes. Force layout frames then
+// cost one getRevision() call plus the layout itself.
+function getGraphSnapshot() {
+    if (!graph || !graph.getMatrix) {
+        return null;
+    }
     
-    let hasEdges = false;
+    const revision = graph.getRevision ? graph.getRevision() : null;
+    if (graphSnapshot && graphSnapshot.graph === graph &&
+        revision !== null && graphSnapshot.revision === revision) {
+        return graphSnapshot;
+    }
+    
+    const matrix = parseMatrix(graph.getMatrix());
+    const isDirected = !!(graph.getIsDirected && graph.getIsDirected());
+    const nodeCount = matrix ? matrix.length : 0;
+    const edges = graphEdgeList(matrix, nodeCount, isDirected);
     
+    graphSnapshot = { graph, revision, matrix, nodeCount, isDirected, edges };
+    return graphSnapshot;
+}
+
+function graphEdgeList(matrix, nodeCount, isDirected) {
+    const edges = [];
     for (let i = 0; i < nodeCount; i++) {
         for (let j = 0; j < nodeCount; j++) {
-            if (matrix[i][j] !== 0) {
-                hasEdges = true;
-                const from = nodePositions[i];
-                const to = nodePositions[j];
-                
-                // For undirected graphs, only draw once (i <= j)
-                if (!isDirected && i > j) continue;
-                
-                if (i === j) {
-                    drawSelfLoop(ctx, from, matrix[i][j], isDirected);
-                } else {
-                    if (isDirected) {
-                        drawDirectedEdge(ctx, from, to, matrix[i][j]);
-                    } else {
-                        drawUndirectedEdge(ctx, from, to, matrix[i][j]);
-                    }
-                }
+            // For undirected graphs, only keep each edge once (i <= j)
+            if (matrix[i][j] !== 0 && (isDirected || i <= j)) {
+                edges.push({ u: i, v: j, weight: matrix[i][j] });
             }
         }
     }
+    return edges;
+}
+
+function getCircleLayoutPositions(nodeCount) {
+    const centerX = 400;
+    const centerY = 250;
+    
+    // Adjust radius based on node count for better visualization
+    const baseRadius = 150;
+    const radius = Math.max(80, Math.min(baseRadius, baseRadius - (nodeCount - 6) * 10));
+    
+    const nodePositions = [];
+    for (let i = 0; i < nodeCount; i++) {
+        const angle = (2 * Math.PI * i) / nodeCount;
+        const x = centerX + radius * Math.cos(angle);
+        const y = centerY + radius * Math.sin(angle);
+        nodePositions.push({ x, y, index: i });
+    }
+    return nodePositions;
+}
+
+// Show graph info
+function drawGraphInfo(ctx, nodeCount, isDirected) {
+    ctx.fillStyle = '#4a5568';
+    ctx.font = '14px Arial';
+    ctx.textAlign = 'center';
+    ctx.textBaseline = 'middle';
+    ctx.fillText(`Nodes: ${nodeCount} | Type: ${isDirected ? 'Directed' : 'Undirected'}`, 400, 80);
+    
+    if (currentGraphType) {
+        ctx.fillStyle = getGraphAlgorithmColor(currentGraphType);
+        ctx.fillText(`Current Algorithm: ${currentGraphType.toUpperCase()}`, 400, 100);
+    }
+}
+
+function drawGraphEmptyHint(ctx) {
+    ctx.fillStyle = '#a0aec0';
+    ctx.font = '16px Arial';
+    ctx.textAlign = 'center';
+    ctx.textBaseline = 'middle';
+    ctx.fillText('No edges added. Use "Add Edge" to connect nodes.', 400, 450);
+}
+
+// Everything besides the edges themselves that a partial repaint keeps
+function graphRenderKey(nodeCount, isDirected, edges) {
+    return `${nodeCount}:${isDirected}:${edges}:${currentGraphType}:${currentGraphPath.join(',')}`;
+}
+
+// Covers the edge line, its weight label, arrow head or self-loop
+function graphEdgeBounds(from, to) {
+    if (from === to) {
+        return { x: from.x - 30, y: from.y - 68, w: 60, h: 70 };
+    }
+    const pad = 30;
+    const x = Math.min(from.x, to.x) - pad;
+    const y = Math.min(from.y, to.y) - pad;
+    return { x, y, w: Math.abs(from.x - to.x) + 2 * pad, h: Math.abs(from.y - to.y) + 2 * pad };
+}
+
+// Covers the node, its shadow and the path order label above it
+function graphNodeBounds(node) {
+    return { x: node.x - 24, y: node.y - 44, w: 48, h: 70 };
+}
+
+// Changes are (u, v) vertex pairs of added or removed edges; only the
+// circle layout is repainted in place, the force layout redraws as it moves.
+// The snapshot drawn last is patched with getWeight() for just those pairs.
+function repaintGraphChanges(ctx, changes) {
+    const snapshot = graphSnapshot;
+    if (!graph || !graph.getWeight || !graph.getRevision ||
+        !snapshot || snapshot.graph !== graph || snapshot.nodeCount > 15) {
+        return false;
+    }
+    
+    const nodeCount = snapshot.nodeCount;
+    const isDirected = snapshot.isDirected;
+    const nodePositions = getCircleLayoutPositions(nodeCount);
+    const rects = [];
+    for (let k = 0; k + 1 < changes.length; k += 2) {
+        const u = changes[k];
+        const v = changes[k + 1];
+        if (u < 0 || u >= nodeCount || v < 0 || v >= nodeCount) {
+            return false;
+        }
+        const weight = graph.getWeight(u, v);
+        snapshot.matrix[u][v] = weight;
+        if (!isDirected) {
+            snapshot.matrix[v][u] = weight;
+        }
+        rects.push(graphEdgeBounds(nodePositions[u], nodePositions[v]));
+    }
+    if (rects.length > 0) {
+        snapshot.edges = graphEdgeList(snapshot.matrix, nodeCount, isDirected);
+    }
+    snapshot.revision = graph.getRevision();
+    
+    const edges = snapshot.edges.length > 0;
+    if (graphRenderKey(nodeCount, isDirected, edges) !== graphRenderedKey) {
+        return false;
+    }
+    if (rects.length === 0) {
+        return true;
+    }
+    
+    const items = [];
+    const addItem = (bounds, draw) => {
+        if (rects.some(r => rectsIntersect(r, bounds))) {
+            items.push({ bounds, draw });
+        }
+    };
+    snapshot.edges.forEach(edge => {
+        const from = nodePositions[edge.u];
+        const to = nodePositions[edge.v];
+        addItem(graphEdgeBounds(from, to), c => drawGraphEdges(c, [edge], nodePositions, isDirected));
+    });
+    nodePositions.forEach(node => {
+        addItem(graphNodeBounds(node), c => drawGraphNodes(c, [node], nodeCount));
+    });
+    addItem({ x: 0, y: 66, w: 800, h: 44 }, c => drawGraphInfo(c, nodeCount, isDirected));
+    if (!edges) {
+        addItem({ x: 150, y: 436, w: 500, h: 28 }, drawGraphEmptyHint);
+    }
+    
+    repaintRegions(ctx, rects, items);
+    return true;
+}
+
+// Advance the C++ layout a few steps and fit it to the canvas; keeps
+// redrawing on animation frames until the layout settles
+let graphLayoutFrame = null;
+
+function getForceLayoutPositions(nodeCount) {
+    if (!graph.layoutStep || !graph.getLayout) {
+        return null;
+    }
+    
+    const moving = graph.layoutStep(5);
+    const layout = graph.getLayout();
+    if (layout.length !== nodeCount * 2) {
+        return null;
+    }
+    
+    let minX = Infinity, maxX = -Infinity, minY = Infinity, maxY = -Infinity;
+    for (let i = 0; i < nodeCount; i++) {
+        minX = Math.min(minX, layout[i]);
+        maxX = Math.max(maxX, layout[i]);
+        minY = Math.min(minY, layout[nodeCount + i]);
+        maxY = Math.max(maxY, layout[nodeCount + i]);
+    }
+    
+    const left = 60, right = 740, top = 120, bottom = 430;
+    const scale = Math.min((right - left) / Math.max(maxX - minX, 1e-6),
+                           (bottom - top) / Math.max(maxY - minY, 1e-6));
+    const offsetX = (left + right) / 2 - scale * (minX + maxX) / 2;
+    const offsetY = (top + bottom) / 2 - scale * (minY + maxY) / 2;
+    
+    const nodePositions = [];
+    for (let i = 0; i < nodeCount; i++) {
+        nodePositions.push({
+            x: offsetX + scale * layout[i],
+            y: offsetY + scale * layout[nodeCount + i],
+            index: i
+        });
+    }
+    
+    if (moving && graphLayoutFrame === null) {
+        graphLayoutFrame = requestAnimationFrame(() => {
+            graphLayoutFrame = null;
+            if (currentDS === 'graph') {
+                updateVisualization();
+            }
+        });
+    }
+    
+    return nodePositions;
+}
+
+function drawGraphEdges(ctx, edges, nodePositions, isDirected) {
+    ctx.save();
+    
+    edges.forEach(edge => {
+        const from = nodePositions[edge.u];
+        const to = nodePositions[edge.v];
+        
+        if (edge.u === edge.v) {
+            drawSelfLoop(ctx, from, edge.weight, isDirected);
+        } else if (isDirected) {
+            drawDirectedEdge(ctx, from, to, edge.weight);
+        } else {
+            drawUndirectedEdge(ctx, from, to, edge.weight);
+        }
+    });
     
     ctx.restore();
-    return hasEdges;
+    return edges.length > 0;
 }
 
 function drawSelfLoop(ctx, node, weight, isDirected) {
@@ -1622,11 +2213,10 @@ function drawArrowHead(ctx, x, y, angle) {
     ctx.restore();
 }
 
-function drawGraphNodes(ctx, nodePositions) {
+function drawGraphNodes(ctx, nodePositions, nodeCount = nodePositions.length) {
     ctx.save();
     
     const baseNodeRadius = 20;
-    const nodeCount = nodePositions.length;
     const nodeRadius = Math.max(15, Math.min(baseNodeRadius, baseNodeRadius - (nodeCount - 6) * 1));
     const baseFontSize = 16;
     const fontSize = Math.max(12, Math.min(baseFontSize, baseFontSize - (nodeCount - 6) * 0.5));
@@ -1730,17 +2320,6 @@ function parseMatrix(matrixStr) {
     }
 }
 
-function hasEdges(matrix, nodeCount) {
-    for (let i = 0; i < nodeCount; i++) {
-        for (let j = 0; j < nodeCount; j++) {
-            if (matrix[i][j] !== 0) {
-                return true;
-            }
-        }
-    }
-    return false;
-}
-
 // Hash Table Visualization
 function visualizeHashTable(ctx) {
     ctx.fillStyle = '#2d3748';
@@ -1756,65 +2335,11 @@ function visualizeHashTable(ctx) {
         
         const tableStr = hashTable.getTable();
         
-        // Parse the table string to get buckets
-        const buckets = tableStr.slice(1, -1).split('],[').map(bucket => 
-            bucket.replace(/[\[\]]/g, '').split(',').filter(x => x.trim() !== '')
-        );
+        const buckets = parseHashTable(tableStr);
+        hashBuckets = { table: hashTable, buckets };
         
-        const startX = 100;
-        const startY = 120;
-        const bucketWidth = 120;
-        const bucketHeight = 40;
-        const horizontalSpacing = 20;
-        const verticalSpacing = 60;
-        const bucketsPerRow = 5;
-        
-        ctx.font = '14px Arial';
-        ctx.textAlign = 'left';
-        ctx.fillText(`Table State: ${tableStr}`, 50, 80);
-        
-        buckets.forEach((bucket, index) => {
-            const row = Math.floor(index / bucketsPerRow);
-            const col = index % bucketsPerRow;
-            const x = startX + col * (bucketWidth + horizontalSpacing);
-            const y = startY + row * (bucketHeight + verticalSpacing);
-            
-            // Draw bucket background
-            ctx.fillStyle = '#f7fafc';
-            ctx.fillRect(x, y, bucketWidth, bucketHeight);
-            
-            ctx.strokeStyle = '#4a5568';
-            ctx.lineWidth = 2;
-            ctx.strokeRect(x, y, bucketWidth, bucketHeight);
-            
-            // Draw bucket index
-            ctx.fillStyle = '#2d3748';
-            ctx.font = 'bold 14px Arial';
-            ctx.textAlign = 'center';
-            ctx.fillText(`Bucket ${index}`, x + bucketWidth/2, y - 10);
-            
-            if (bucket.length > 0) {
-                // Draw key-value pairs
-                ctx.fillStyle = '#9f7aea';
-                ctx.font = '12px Arial';
-                
-                if (bucket.length === 1) {
-                    // Single item - center it
-                    ctx.fillText(bucket[0], x + bucketWidth/2, y + bucketHeight/2);
-                } else {
-                    // Multiple items - distribute vertically
-                    const itemHeight = bucketHeight / bucket.length;
-                    bucket.forEach((kv, kvIndex) => {
-                        const itemY = y + (kvIndex * itemHeight) + (itemHeight / 2);
-                        ctx.fillText(kv, x + bucketWidth/2, itemY);
-                    });
-                }
-            } else {
-                ctx.fillStyle = '#a0aec0';
-                ctx.font = '12px Arial';
-                ctx.fillText('Empty', x + bucketWidth/2, y + bucketHeight/2);
-            }
-        });
+        drawHashHeader(ctx, tableStr);
+        buckets.forEach((bucket, index) => drawHashBucket(ctx, bucket, index));
         
         // Draw legend for large tables
         if (buckets.length > 10) {
@@ -1830,6 +2355,123 @@ function visualizeHashTable(ctx) {
     }
 }
 
+// Parse the table string to get buckets
+function parseHashTable(tableStr) {
+    return tableStr.slice(1, -1).split('],[').map(parseHashBucket);
+}
+
+// "[12:5,2:7]" -> ["12:5", "2:7"]
+function parseHashBucket(bucketStr) {
+    return bucketStr.replace(/[\[\]]/g, '').split(',').filter(x => x.trim() !== '');
+}
+
+// Same text as getTable(), rebuilt from the parsed buckets
+function hashTableText(buckets) {
+    return `[${buckets.map(bucket => `[${bucket.join(',')}]`).join(',')}]`;
+}
+
+const HASH_BUCKET_WIDTH = 120;
+const HASH_BUCKET_HEIGHT = 40;
+
+function hashBucketPosition(index) {
+    const bucketsPerRow = 5;
+    const row = Math.floor(index / bucketsPerRow);
+    const col = index % bucketsPerRow;
+    return {
+        x: 100 + col * (HASH_BUCKET_WIDTH + 20),
+        y: 120 + row * (HASH_BUCKET_HEIGHT + 60)
+    };
+}
+
+// Bucket box plus its label; wide enough for entries that overflow the box
+function hashBucketBounds(index) {
+    const { x, y } = hashBucketPosition(index);
+    return { x: x - 10, y: y - 30, w: HASH_BUCKET_WIDTH + 20, h: HASH_BUCKET_HEIGHT + 32 };
+}
+
+function drawHashHeader(ctx, tableStr) {
+    ctx.fillStyle = '#2d3748';
+    ctx.font = '14px Arial';
+    ctx.textAlign = 'left';
+    ctx.textBaseline = 'middle';
+    ctx.fillText(`Table State: ${tableStr}`, 50, 80);
+}
+
+function drawHashBucket(ctx, bucket, index) {
+    const { x, y } = hashBucketPosition(index);
+    const bucketWidth = HASH_BUCKET_WIDTH;
+    const bucketHeight = HASH_BUCKET_HEIGHT;
+    
+    // Draw bucket background
+    ctx.fillStyle = '#f7fafc';
+    ctx.fillRect(x, y, bucketWidth, bucketHeight);
+    
+    ctx.strokeStyle = '#4a5568';
+    ctx.lineWidth = 2;
+    ctx.strokeRect(x, y, bucketWidth, bucketHeight);
+    
+    // Draw bucket index
+    ctx.fillStyle = '#2d3748';
+    ctx.font = 'bold 14px Arial';
+    ctx.textAlign = 'center';
+    ctx.fillText(`Bucket ${index}`, x + bucketWidth/2, y - 10);
+    
+    if (bucket.length > 0) {
+        // Draw key-value pairs
+        ctx.fillStyle = '#9f7aea';
+        ctx.font = '12px Arial';
+        
+        if (bucket.length === 1) {
+            // Single item - center it
+            ctx.fillText(bucket[0], x + bucketWidth/2, y + bucketHeight/2);
+        } else {
+            // Multiple items - distribute vertically
+            const itemHeight = bucketHeight / bucket.length;
+            bucket.forEach((kv, kvIndex) => {
+                const itemY = y + (kvIndex * itemHeight) + (itemHeight / 2);
+                ctx.fillText(kv, x + bucketWidth/2, itemY);
+            });
+        }
+    } else {
+        ctx.fillStyle = '#a0aec0';
+        ctx.font = '12px Arial';
+        ctx.fillText('Empty', x + bucketWidth/2, y + bucketHeight/2);
+    }
+}
+
+// Changes are bucket indices; only those buckets are read back, with
+// getBucket(), into the buckets parsed by the last full draw
+function repaintHashChanges(ctx, changes) {
+    if (changes.length === 0) {
+        return true;
+    }
+    if (!hashTable.getBucket || !hashBuckets || hashBuckets.table !== hashTable) {
+        return false;
+    }
+    
+    const buckets = hashBuckets.buckets;
+    const header = { x: 0, y: 62, w: 800, h: 26 };
+    const rects = [header];
+    for (const index of new Set(changes)) {
+        if (index < 0 || index >= buckets.length) {
+            return false;
+        }
+        buckets[index] = parseHashBucket(hashTable.getBucket(index));
+        rects.push(hashBucketBounds(index));
+    }
+    
+    const items = [{ bounds: header, draw: c => drawHashHeader(c, hashTableText(buckets)) }];
+    buckets.forEach((bucket, index) => {
+        const bounds = hashBucketBounds(index);
+        if (rects.some(r => rectsIntersect(r, bounds))) {
+            items.push({ bounds, draw: c => drawHashBucket(c, bucket, index) });
+        }
+    });
+    
+    repaintRegions(ctx, rects, items);
+    return true;
+}
+
 // Clean up
 window.addEventListener('beforeunload', function() {
     if (binaryHeap && binaryHeap.delete) binaryHeap.delete();
@@ -0,0 +1,79 @@
+// Native lookup benchmark: AVLTree::contains (pointer chasing) against the
+// FrozenIndex returned by AVLTree::freeze(), one query at a time and in
+// batches with findBatch().
+//
+//   g++ -O2 -std=c++17 benchmark.cpp -o benchmark
+//   ./benchmark [keys] [queries]
+#include "data_structures.cpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+// xorshift, so runs are repeatable without <random>
+unsigned int nextRandom(unsigned int& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point begin) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+}
+
+void report(const char* name, double ms, int queries, int hits) {
+    printf("%-24s %10.2f ms %8.1f ns/lookup %10d hits\n", name, ms, ms * 1e6 / queries, hits);
+}
+
+int main(int argc, char** argv) {
+    int keys = argc > 1 ? atoi(argv[1]) : 1000000;
+    int queries = argc > 2 ? atoi(argv[2]) : 4000000;
+    if (keys < 1) keys = 1;
+    if (queries < 1) queries = 1;
+
+    unsigned int state = 2463534242u;
+    AVLTree tree;
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < keys; i++)
+        tree.insert(nextRandom(state) % (4 * (unsigned int)keys));
+    double buildMs = elapsedMs(begin);
+
+    begin = std::chrono::steady_clock::now();
+    FrozenIndex* index = tree.freeze();
+    double freezeMs = elapsedMs(begin);
+    if (!index) {
+        fprintf(stderr, "freeze failed\n");
+        return 1;
+    }
+
+    // Queries are drawn from the same range as the keys, so roughly a
+    // fifth of them hit
+    int* query = new int[queries];
+    int* found = new int[queries];
+    for (int i = 0; i < queries; i++)
+        query[i] = nextRandom(state) % (4 * (unsigned int)keys);
+
+    printf("%d distinct keys (tree build %.2f ms, freeze %.2f ms), %d random queries\n\n",
+        index->getSize(), buildMs, freezeMs, queries);
+
+    int hits = 0;
+    begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < queries; i++)
+        hits += tree.contains(query[i]);
+    report("AVLTree::contains", elapsedMs(begin), queries, hits);
+
+    int frozenHits = 0;
+    begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < queries; i++)
+        frozenHits += index->contains(query[i]);
+    report("FrozenIndex::contains", elapsedMs(begin), queries, frozenHits);
+
+    begin = std::chrono::steady_clock::now();
+    int batchHits = index->findBatch(query, queries, found);
+    report("FrozenIndex::findBatch", elapsedMs(begin), queries, batchHits);
+
+    delete[] query;
+    delete[] found;
+    delete index;
+    return hits == frozenHits && hits == batchHits ? 0 : 1;
+}
@@ -1,8 +1,25 @@
+// Built with emcc for the browser; natively (e.g. by replay.cpp) the
+// bindings and typed-array views are left out.
+#ifdef __EMSCRIPTEN__
 #include <emscripten/emscripten.h>
 #include <emscripten/bind.h>
+#include <emscripten/val.h>
+#endif
 #include <string>
-
+#include <math.h>
+#include <limits.h>
+#ifndef __EMSCRIPTEN__
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <thread>
+#endif
+
+#ifdef __EMSCRIPTEN__
 using namespace emscripten;
+#endif
 using namespace std;
 
 // ===================== INT TO STRING =====================
@@ -25,6 +42,394 @@ string intToString(int num) {
     }
     return result;
 }
+
+// ===================== MEMORY TRACKING =====================
+// Every structure charges its allocations to its own MemoryStats, which
+// forwards them to a per-type total and then to the global total.
+struct MemoryStats {
+    int liveBytes;
+    int allocCount;
+    int peakBytes;
+    MemoryStats* parent;
+
+    MemoryStats(MemoryStats* parent = NULL) : liveBytes(0), allocCount(0), peakBytes(0), parent(parent) {}
+
+    void add(int bytes) {
+        liveBytes += bytes;
+        allocCount++;
+        if (liveBytes > peakBytes)
+            peakBytes = liveBytes;
+        if (parent)
+            parent->add(bytes);
+    }
+
+    void remove(int bytes) {
+        liveBytes -= bytes;
+        if (parent)
+            parent->remove(bytes);
+    }
+
+    string toString() {
+        return intToString(liveBytes) + ":" +
+            intToString(allocCount) + ":" +
+            intToString(peakBytes);
+    }
+};
+
+MemoryStats totalMemory;
+MemoryStats heapMemory(&totalMemory);
+MemoryStats avlMemory(&totalMemory);
+MemoryStats graphMemory(&totalMemory);
+MemoryStats hashMemory(&totalMemory);
+MemoryStats logMemory(&totalMemory);
+MemoryStats commandMemory(&totalMemory);
+
+// 0 means unlimited
+int memoryBudget = 0;
+
+bool memoryAvailable(int bytes) {
+    return memoryBudget <= 0 || totalMemory.liveBytes + bytes <= memoryBudget;
+}
+
+void setMemoryBudget(int bytes) {
+    memoryBudget = bytes;
+}
+
+int getMemoryBudget() {
+    return memoryBudget;
+}
+
+// Format: [type:live:allocs:peak,...,Total:live:allocs:peak:budget]
+
+string memoryReport() {
+    return "[BinaryHeap:" + heapMemory.toString() +
+        ",AVLTree:" + avlMemory.toString() +
+        ",Graph:" + graphMemory.toString() +
+        ",HashTable:" + hashMemory.toString() +
+        ",OpLog:" + logMemory.toString() +
+        ",CommandBuffer:" + commandMemory.toString() +
+        ",Total:" + totalMemory.toString() + ":" + intToString(memoryBudget) + "]";
+}
+
+// ===================== TRACE LOG =====================
+// Fixed-size step events recorded by algorithms for animation. Each event
+// is 4 ints: [type, a, b, c]. Structures hold a NULL TraceLog* while
+// tracing is disabled, so the only cost is a pointer check.
+enum TraceEvent {
+    TRACE_VISIT = 1,    // vertex
+    TRACE_ENQUEUE = 2,  // vertex, from
+    TRACE_RELAX = 3,    // from, to, new distance/key
+    TRACE_SETTLE = 4,   // vertex, distance/key, parent
+    TRACE_SWAP = 5,     // index, index (0-based array slots)
+    TRACE_ROTATE = 6    // direction (0 left, 1 right), pivot value
+};
+
+class TraceLog {
+private:
+    static const int EVENT_INTS = 4;
+
+    int* events;
+    int capacity;
+    int count;
+    int dropped;
+
+public:
+    TraceLog(int cap) : capacity(cap), count(0), dropped(0) {
+        events = new int[capacity * EVENT_INTS];
+    }
+
+    ~TraceLog() {
+        delete[] events;
+    }
+
+    // Largest capacity whose byte size still fits in an int
+    static const int MAX_CAPACITY = INT_MAX / (EVENT_INTS * sizeof(int));
+
+    static int bytesFor(int cap) {
+        return cap * EVENT_INTS * sizeof(int);
+    }
+
+    int bytes() {
+        return bytesFor(capacity);
+    }
+
+    // Events past capacity are counted but not stored
+    void record(int type, int a, int b = 0, int c = 0) {
+        if (count == capacity) {
+            dropped++;
+            return;
+        }
+        int* e = events + count * EVENT_INTS;
+        e[0] = type;
+        e[1] = a;
+        e[2] = b;
+        e[3] = c;
+        count++;
+    }
+
+    void clear() {
+        count = 0;
+        dropped = 0;
+    }
+
+    int getDropped() {
+        return dropped;
+    }
+
+#ifdef __EMSCRIPTEN__
+    val view() {
+        return val(typed_memory_view(count * EVENT_INTS, events));
+    }
+#endif
+};
+
+// ===================== CHANGE SET =====================
+// What a structure changed since the renderer last called resetChanges().
+// data[0] is 1 when everything must be repainted (new structure, bulk
+// change or overflow), followed by the changed items.
+class ChangeSet {
+private:
+    static const int CAPACITY = 256;
+
+    int data[CAPACITY + 1];
+    int length;
+
+public:
+    ChangeSet() : length(1) {
+        data[0] = 1;
+    }
+
+    void add(int item) {
+        if (data[0])
+            return;
+        if (length == CAPACITY + 1) {
+            markAll();
+            return;
+        }
+        data[length++] = item;
+    }
+
+    void markAll() {
+        data[0] = 1;
+        length = 1;
+    }
+
+    void reset() {
+        data[0] = 0;
+        length = 1;
+    }
+
+#ifdef __EMSCRIPTEN__
+    val view() {
+        return val(typed_memory_view(length, data));
+    }
+#endif
+};
+
+// ===================== OPCODES =====================
+// Shared by CommandBuffer and the operation log: each record is
+// [op, target, args...] with a fixed operand count per opcode.
+enum Opcode {
+    OP_HEAP_INSERT = 1,         // target, value
+    OP_HEAP_EXTRACT = 2,        // target
+    OP_HEAP_CLEAR = 3,          // target
+    OP_AVL_INSERT = 4,          // target, value
+    OP_AVL_REMOVE = 5,          // target, value
+    OP_AVL_CLEAR = 6,           // target
+    OP_GRAPH_ADD_EDGE = 7,      // target, u, v, w
+    OP_GRAPH_REMOVE_EDGE = 8,   // target, u, v
+    OP_GRAPH_CLEAR = 9,         // target
+    OP_HASH_INSERT = 10,        // target, key, value
+    OP_HASH_SEARCH = 11,        // target, key
+    OP_HASH_CLEAR = 12,         // target
+    OP_HEAP_CONVERT = 13,       // target, isMin
+    OP_HEAP_GET_ARRAY = 14,     // target
+    OP_AVL_GET_TREE = 15,       // target
+    OP_GRAPH_SET_DIRECTED = 16, // target, directed
+    OP_GRAPH_GET_MATRIX = 17,   // target
+    OP_GRAPH_BFS = 18,          // target, start
+    OP_GRAPH_DFS = 19,          // target, start
+    OP_GRAPH_DIJKSTRA = 20,     // target, start
+    OP_GRAPH_PRIM = 21,         // target
+    OP_HASH_GET_TABLE = 22,     // target
+    OP_GRAPH_REMOVE_VERTEX = 23, // target, vertex (log only)
+    OP_CREATE_HEAP = 24,        // target, isMin (log only)
+    OP_CREATE_AVL = 25,         // target (log only)
+    OP_CREATE_GRAPH = 26,       // target, vertices, directed (log only)
+    OP_CREATE_HASH = 27,        // target (log only)
+    OP_DESTROY = 28,            // target (log only)
+    OP_HEAP_SET_BOUND = 29,     // target, k
+    OP_HEAP_DRAIN = 30,         // target
+    OP_AVL_CONTAINS = 31,       // target, value
+    OP_GRAPH_LAYOUT_STEP = 32,  // target, iterations
+    OP_COUNT = 33
+};
+
+enum TargetType {
+    TARGET_NONE,
+    TARGET_HEAP,
+    TARGET_AVL,
+    TARGET_GRAPH,
+    TARGET_HASH
+};
+
+// Number of ints after the opcode (target included), -1 if unknown
+int opOperands(int op) {
+    static const int counts[OP_COUNT] = {
+        -1, 2, 1, 1, 2, 2, 1, 4, 3, 1, 3, 2, 1,
+        2, 1, 1, 2, 1, 2, 2, 2, 1, 1,
+        2, 2, 1, 3, 1, 1, 2, 1, 2, 2
+    };
+    return (op > 0 && op < OP_COUNT) ? counts[op] : -1;
+}
+
+TargetType opTargetType(int op) {
+    switch (op) {
+    case OP_HEAP_INSERT: case OP_HEAP_EXTRACT: case OP_HEAP_CLEAR:
+    case OP_HEAP_CONVERT: case OP_HEAP_GET_ARRAY: case OP_CREATE_HEAP:
+    case OP_HEAP_SET_BOUND: case OP_HEAP_DRAIN:
+        return TARGET_HEAP;
+    case OP_AVL_INSERT: case OP_AVL_REMOVE: case OP_AVL_CLEAR:
+    case OP_AVL_GET_TREE: case OP_CREATE_AVL: case OP_AVL_CONTAINS:
+        return TARGET_AVL;
+    case OP_GRAPH_ADD_EDGE: case OP_GRAPH_REMOVE_EDGE: case OP_GRAPH_CLEAR:
+    case OP_GRAPH_SET_DIRECTED: case OP_GRAPH_GET_MATRIX: case OP_GRAPH_BFS:
+    case OP_GRAPH_DFS: case OP_GRAPH_DIJKSTRA: case OP_GRAPH_PRIM:
+    case OP_GRAPH_REMOVE_VERTEX: case OP_CREATE_GRAPH: case OP_GRAPH_LAYOUT_STEP:
+        return TARGET_GRAPH;
+    case OP_HASH_INSERT: case OP_HASH_SEARCH: case OP_HASH_CLEAR:
+    case OP_HASH_GET_TABLE: case OP_CREATE_HASH:
+        return TARGET_HASH;
+    }
+    return TARGET_NONE;
+}
+
+// Opcodes that only appear in operation logs, never in a CommandBuffer
+bool opLogOnly(int op) {
+    return op >= OP_GRAPH_REMOVE_VERTEX && op <= OP_DESTROY;
+}
+
+// ===================== OPERATION LOG =====================
+// Records every public call on BinaryHeap, AVLTree, Graph and HashTable
+// as opcode records so a session can be replayed natively (replay.cpp).
+// A structure first seen while recording gets a target id and a CREATE
+// record followed by ops that rebuild its current contents.
+
+class OpLog {
+private:
+    int* data;
+    int length;
+    int capacity;
+    int nextTarget;
+    bool truncated;
+
+    bool reserve(int ints) {
+        if (length + ints <= capacity)
+            return true;
+        int grown = capacity * 2;
+        if (grown < length + ints) grown = length + ints;
+        int extra = (grown - capacity) * sizeof(int);
+        if (!memoryAvailable(extra))
+            return false;
+        int* bigger = new int[grown];
+        for (int i = 0; i < length; i++) bigger[i] = data[i];
+        delete[] data;
+        data = bigger;
+        capacity = grown;
+        logMemory.add(extra);
+        return true;
+    }
+
+public:
+    bool recording;
+    int generation;
+
+    OpLog() : data(NULL), length(0), capacity(0), nextTarget(0), truncated(false),
+        recording(false), generation(0) {}
+
+    ~OpLog() {
+        delete[] data;
+    }
+
+    void start(int initialCapacity) {
+        delete[] data;
+        logMemory.remove(capacity * sizeof(int));
+        data = NULL;
+        length = 0;
+        capacity = 0;
+        nextTarget = 0;
+        truncated = false;
+        generation++;
+        recording = true;
+        reserve(initialCapacity > 16 ? initialCapacity : 16);
+    }
+
+    void stop() {
+        recording = false;
+    }
+
+    // Ids handed out in an earlier recording are stale
+    bool owns(int id, int idGeneration) {
+        return id >= 0 && idGeneration == generation;
+    }
+
+    int newTarget(int& idGeneration) {
+        idGeneration = generation;
+        return nextTarget++;
+    }
+
+    // Stops recording once the memory budget refuses to grow the log
+    void record(int op, int target, int a = 0, int b = 0, int c = 0) {
+        int operands = opOperands(op);
+        if (!recording || !reserve(1 + operands)) {
+            if (recording) truncated = true;
+            recording = false;
+            return;
+        }
+        int args[3] = { a, b, c };
+        data[length++] = op;
+        data[length++] = target;
+        for (int i = 0; i < operands - 1; i++)
+            data[length++] = args[i];
+    }
+
+    int getLength() {
+        return length;
+    }
+
+    bool isTruncated() {
+        return truncated;
+    }
+
+#ifdef __EMSCRIPTEN__
+    val view() {
+        return val(typed_memory_view(length, data));
+    }
+#endif
+};
+
+OpLog opLog;
+
+void startRecording(int initialCapacity) {
+    opLog.start(initialCapacity);
+}
+
+// Returns the number of ints recorded
+int stopRecording() {
+    opLog.stop();
+    return opLog.getLength();
+}
+
+bool isRecordingTruncated() {
+    return opLog.isTruncated();
+}
+
+#ifdef __EMSCRIPTEN__
+val getRecording() {
+    return opLog.view();
+}
+#endif
+
 // ===================== LINKED LIST NODE =====================
 struct Node {
     int data;
@@ -198,13 +603,143 @@ public:
     }
 };
 
+// ===================== PERSISTENT VERSIONS =====================
+// Persistent structures share nodes between versions. Every pointer to a
+// node (parent link, live root or saved version) holds one reference.
+template <typename T>
+void retainNode(T* node) {
+    if (node)
+        node->refs++;
+}
+
+// Frees every node whose last reference is dropped. Iterative because
+// leftist heaps can have long left spines.
+template <typename T>
+void releaseNode(T* node, MemoryStats& mem) {
+    if (!node || --node->refs > 0)
+        return;
+
+    int capacity = 16;
+    int count = 0;
+    T** pending = new T* [capacity];
+    pending[count++] = node;
+
+    while (count > 0) {
+        T* current = pending[--count];
+        T* children[2] = { current->left, current->right };
+        for (int i = 0; i < 2; i++) {
+            if (!children[i] || --children[i]->refs > 0)
+                continue;
+            if (count == capacity) {
+                T** grown = new T* [capacity * 2];
+                for (int j = 0; j < count; j++) grown[j] = pending[j];
+                delete[] pending;
+                pending = grown;
+                capacity *= 2;
+            }
+            pending[count++] = children[i];
+        }
+        delete current;
+        mem.remove(sizeof(T));
+    }
+
+    delete[] pending;
+}
+
+// Saved roots of a persistent structure, addressed by increasing version
+// ids. When full, a new snapshot evicts the oldest version.
+template <typename T>
+class VersionTable {
+private:
+    static const int MAX_VERSIONS = 64;
+
+    T* roots[MAX_VERSIONS];
+    int ids[MAX_VERSIONS];
+    int nextId;
+    int live;
+    MemoryStats* mem;
+
+    int slotOf(int id) {
+        if (id < 0 || id >= nextId)
+            return -1;
+        int slot = id % MAX_VERSIONS;
+        return ids[slot] == id ? slot : -1;
+    }
+
+public:
+    VersionTable(MemoryStats* mem) : nextId(0), live(0), mem(mem) {
+        for (int i = 0; i < MAX_VERSIONS; i++) {
+            roots[i] = NULL;
+            ids[i] = -1;
+        }
+    }
+
+    ~VersionTable() {
+        releaseAll();
+    }
+
+    int snapshot(T* root) {
+        int id = nextId++;
+        int slot = id % MAX_VERSIONS;
+        if (ids[slot] != -1) {
+            releaseNode(roots[slot], *mem);
+            live--;
+        }
+        retainNode(root);
+        roots[slot] = root;
+        ids[slot] = id;
+        live++;
+        return id;
+    }
+
+    bool find(int id, T*& root) {
+        int slot = slotOf(id);
+        if (slot == -1)
+            return false;
+        root = roots[slot];
+        return true;
+    }
+
+    bool release(int id) {
+        int slot = slotOf(id);
+        if (slot == -1)
+            return false;
+        releaseNode(roots[slot], *mem);
+        roots[slot] = NULL;
+        ids[slot] = -1;
+        live--;
+        return true;
+    }
+
+    void releaseAll() {
+        for (int i = 0; i < MAX_VERSIONS; i++) {
+            if (ids[i] != -1) {
+                releaseNode(roots[i], *mem);
+                roots[i] = NULL;
+                ids[i] = -1;
+            }
+        }
+        live = 0;
+    }
+
+    int liveCount() {
+        return live;
+    }
+};
+
 // ===================== 1. BINARY HEAP =====================
 class BinaryHeap {
 private:
     int* arr;
     int size;
     int cap;
+    int bound;
     bool isMin;
+    MemoryStats mem;
+    TraceLog* trace;
+    int logId;
+    int logGeneration;
+    ChangeSet changes;
 
     void swap(int& a, int& b) {
         int t = a;
@@ -212,15 +747,38 @@ private:
         b = t;
     }
 
+    int logTarget() {
+        if (!opLog.owns(logId, logGeneration)) {
+            logId = opLog.newTarget(logGeneration);
+            opLog.record(OP_CREATE_HEAP, logId, isMin);
+            // Grow the replayed heap first so the inserts below fit
+            if (cap != 100)
+                opLog.record(OP_HEAP_SET_BOUND, logId, cap);
+            for (int i = 1; i <= size; i++)
+                opLog.record(OP_HEAP_INSERT, logId, arr[i]);
+            if (cap != 100 || bound > 0)
+                opLog.record(OP_HEAP_SET_BOUND, logId, bound);
+        }
+        return logId;
+    }
+
+    void swapSlots(int i, int j) {
+        swap(arr[i], arr[j]);
+        changes.add(i - 1);
+        changes.add(j - 1);
+        if (trace)
+            trace->record(TRACE_SWAP, i - 1, j - 1);
+    }
+
     void heapifyUp(int i) {
         while (i > 1) {
             int parent = i / 2;
             if (isMin && arr[parent] > arr[i]) {
-                swap(arr[i], arr[parent]);
+                swapSlots(i, parent);
                 i = parent;
             }
             else if (!isMin && arr[parent] < arr[i]) {
-                swap(arr[i], arr[parent]);
+                swapSlots(i, parent);
                 i = parent;
             }
             else {
@@ -249,7 +807,7 @@ private:
         }
 
         if (target != i) {
-            swap(arr[i], arr[target]);
+            swapSlots(i, target);
             heapifyDown(target);
         }
     }
@@ -260,48 +818,186 @@ private:
         }
     }
 
+    // A full bounded heap only takes values that beat its root: larger
+    // ones in a min-heap (keeping the K largest), smaller ones in a
+    // max-heap (keeping the K smallest)
+    bool offer(int val) {
+        if (isMin ? val <= arr[1] : val >= arr[1])
+            return false;
+        arr[1] = val;
+        changes.add(0);
+        heapifyDown(1);
+        return true;
+    }
+
 public:
-    BinaryHeap(bool minHeap = true) : size(0), cap(100), isMin(minHeap) {
+    BinaryHeap(bool minHeap = true) : size(0), cap(100), bound(0), isMin(minHeap), mem(&heapMemory), trace(NULL), logId(-1), logGeneration(0) {
         arr = new int[cap + 1];
+        mem.add((cap + 1) * sizeof(int));
     }
 
     ~BinaryHeap() {
+        if (opLog.recording && opLog.owns(logId, logGeneration))
+            opLog.record(OP_DESTROY, logId);
+        disableTrace();
         delete[] arr;
+        mem.remove((cap + 1) * sizeof(int));
     }
 
-    void insert(int val) {
+    bool insert(int val) {
+        if (opLog.recording)
+            opLog.record(OP_HEAP_INSERT, logTarget(), val);
+        if (bound > 0 && size == bound)
+            return offer(val);
         if (size == cap) 
-            return;
+            return false;
         size++;
         arr[size] = val;
+        changes.add(size - 1);
         heapifyUp(size);
+        return true;
     }
 
     int extractTop() {
+        if (opLog.recording)
+            opLog.record(OP_HEAP_EXTRACT, logTarget());
         if (size == 0) 
             return -999999;
         int root = arr[1];
         arr[1] = arr[size];
         size--;
+        changes.add(0);
+        changes.add(size);
         if (size > 0) heapifyDown(1);
         return root;
     }
 
     void convertToMinHeap() {
+        if (opLog.recording)
+            opLog.record(OP_HEAP_CONVERT, logTarget(), 1);
         isMin = true;
         buildHeap();
+        changes.markAll();
     }
 
     void convertToMaxHeap() {
+        if (opLog.recording)
+            opLog.record(OP_HEAP_CONVERT, logTarget(), 0);
         isMin = false;
         buildHeap();
+        changes.markAll();
     }
 
     bool getIsMinHeap() {
         return isMin;
     }
 
+    // Bounded mode: the heap holds at most k items and keeps the k best
+    // values inserted so far (see offer). Grows the array if needed and
+    // drops the worst items if more than k are stored. 0 turns it off.
+    bool setBound(int k) {
+        if (opLog.recording)
+            opLog.record(OP_HEAP_SET_BOUND, logTarget(), k);
+        // The array's byte size, (k + 1) ints, must fit in an int
+        if (k < 0 || k > INT_MAX / (int)sizeof(int) - 1)
+            return false;
+        if (k > cap) {
+            if (!memoryAvailable((k - cap) * sizeof(int)))
+                return false;
+            int* grown = new int[k + 1];
+            for (int i = 1; i <= size; i++)
+                grown[i] = arr[i];
+            delete[] arr;
+            mem.remove((cap + 1) * sizeof(int));
+            arr = grown;
+            cap = k;
+            mem.add((cap + 1) * sizeof(int));
+        }
+
+        bound = k;
+        while (bound > 0 && size > bound) {
+            arr[1] = arr[size];
+            size--;
+            heapifyDown(1);
+        }
+        changes.markAll();
+        return true;
+    }
+
+    int getBound() {
+        return bound;
+    }
+
+    // Inserts count values in one call and returns how many entered the
+    // heap. An unbounded heap stops at the first value that does not fit.
+    int pushValues(const int* values, int count) {
+        changes.markAll();
+        bool recording = opLog.recording;
+        int pushed = 0;
+        for (int i = 0; i < count; i++) {
+            int val = values[i];
+            if (bound > 0 && size == bound) {
+                if (recording)
+                    opLog.record(OP_HEAP_INSERT, logTarget(), val);
+                pushed += offer(val);
+                continue;
+            }
+            if (size == cap)
+                break;
+            if (recording)
+                opLog.record(OP_HEAP_INSERT, logTarget(), val);
+            size++;
+            arr[size] = val;
+            heapifyUp(size);
+            pushed++;
+        }
+        return pushed;
+    }
+
+    // Empties the heap with an in-place heapsort that leaves its items in
+    // arr[1..n] best-first (largest first for a min-heap). Returns n.
+    int drain() {
+        if (opLog.recording)
+            opLog.record(OP_HEAP_DRAIN, logTarget());
+        int n = size;
+        while (size > 1) {
+            swapSlots(1, size);
+            size--;
+            heapifyDown(1);
+        }
+        size = 0;
+        changes.markAll();
+        return n;
+    }
+
+#ifdef __EMSCRIPTEN__
+    // Copies the Int32Array into wasm memory a chunk at a time
+    int pushStream(val values) {
+        const int CHUNK = 1024;
+        int chunk[CHUNK];
+        int length = values["length"].as<int>();
+        int pushed = 0;
+        for (int start = 0; start < length; start += CHUNK) {
+            int count = length - start < CHUNK ? length - start : CHUNK;
+            val(typed_memory_view(count, chunk)).call<void>("set", values.call<val>("subarray", start, start + count));
+            int entered = pushValues(chunk, count);
+            pushed += entered;
+            if (bound == 0 && entered < count)
+                break;
+        }
+        return pushed;
+    }
+
+    // Sorted view of the drained items; valid until the next insert
+    val drainTopK() {
+        int n = drain();
+        return val(typed_memory_view(n, arr + 1));
+    }
+#endif
+
     string getArray() {
+        if (opLog.recording)
+            opLog.record(OP_HEAP_GET_ARRAY, logTarget());
         string result = "[";
         for (int i = 1; i <= size; i++) {
             result += intToString(arr[i]);
@@ -312,232 +1008,1851 @@ public:
         return result;
     }
 
+    int getSize() {
+        return size;
+    }
+
+    // Slot i (0-based, as in getArray()) or -999999 when out of range;
+    // lets the renderer redraw single slots without the whole array
+    int getSlot(int i) {
+        if (i < 0 || i >= size)
+            return -999999;
+        return arr[i + 1];
+    }
+
     void clear() {
+        if (opLog.recording)
+            opLog.record(OP_HEAP_CLEAR, logTarget());
         size = 0;
+        changes.markAll();
+    }
+
+#ifdef __EMSCRIPTEN__
+    val getChanges() {
+        return changes.view();
+    }
+#endif
+
+    void resetChanges() {
+        changes.reset();
+    }
+
+    string getMemoryStats() {
+        return "[" + mem.toString() + "]";
+    }
+
+    bool enableTrace(int capacity) {
+        disableTrace();
+        if (capacity <= 0 || capacity > TraceLog::MAX_CAPACITY || !memoryAvailable(TraceLog::bytesFor(capacity)))
+            return false;
+        trace = new TraceLog(capacity);
+        mem.add(trace->bytes());
+        return true;
+    }
+
+    void disableTrace() {
+        if (trace) {
+            mem.remove(trace->bytes());
+            delete trace;
+            trace = NULL;
+        }
+    }
+
+    void clearTrace() {
+        if (trace)
+            trace->clear();
+    }
+
+#ifdef __EMSCRIPTEN__
+    val getTrace() {
+        return trace ? trace->view() : val(typed_memory_view(0, (int*)NULL));
+    }
+#endif
+
+    int getTraceDropped() {
+        return trace ? trace->getDropped() : 0;
     }
 };
 
-// ===================== 2. AVL TREE =====================
-struct AVLNode {
+// ===================== PERSISTENT HEAP (LEFTIST) =====================
+// Immutable leftist heap: insert/extract build new nodes along the right
+// spines (O(log n)) and share the rest, so snapshot()/restore() are O(1).
+struct LeftistNode {
     int data;
-    AVLNode* left;
-    AVLNode* right;
-    int height;
+    int rank;
+    int count;
+    int refs;
+    LeftistNode* left;
+    LeftistNode* right;
 
-    AVLNode(int val) : data(val), left(NULL), right(NULL), height(0) {}
+    LeftistNode(int val) : data(val), rank(1), count(1), refs(1), left(NULL), right(NULL) {}
 };
 
-class AVLTree {
+class PersistentHeap {
 private:
-    AVLNode* root;
-    string lastRotation;
+    LeftistNode* root;
+    bool isMin;
+    MemoryStats mem;
+    VersionTable<LeftistNode> versions;
 
-    int max(int a, int b) {
-        return (a > b) ? a : b;
+    int rank(LeftistNode* node) {
+        return node ? node->rank : 0;
     }
 
-    int height(AVLNode* node) {
-        return (node) ? node->height : 0;
+    int count(LeftistNode* node) {
+        return node ? node->count : 0;
     }
 
-    void updateHeight(AVLNode* node) {
-        if (node) {
-            node->height = 1 + max(height(node->left), height(node->right));
-        }
+    bool before(int a, int b) {
+        return isMin ? a <= b : a >= b;
     }
 
-    int getBalance(AVLNode* node) {
-        return node ? height(node->left) - height(node->right) : 0;
+    LeftistNode* makeNode(int val, LeftistNode* a, LeftistNode* b) {
+        LeftistNode* node = new LeftistNode(val);
+        mem.add(sizeof(LeftistNode));
+        if (rank(a) >= rank(b)) {
+            node->left = a;
+            node->right = b;
+        }
+        else {
+            node->left = b;
+            node->right = a;
+        }
+        node->rank = rank(node->right) + 1;
+        node->count = count(a) + count(b) + 1;
+        return node;
     }
 
-    AVLNode* rotateRight(AVLNode* y) {
-        lastRotation = "Right rotation on node " + intToString(y->data);
-        AVLNode* x = y->left;
-        AVLNode* T2 = x->right;
+    // Returns a new reference; a and b are left untouched
+    LeftistNode* merge(LeftistNode* a, LeftistNode* b) {
+        if (!a) {
+            retainNode(b);
+            return b;
+        }
+        if (!b) {
+            retainNode(a);
+            return a;
+        }
+        if (!before(a->data, b->data)) {
+            LeftistNode* t = a;
+            a = b;
+            b = t;
+        }
+        LeftistNode* merged = merge(a->right, b);
+        retainNode(a->left);
+        return makeNode(a->data, a->left, merged);
+    }
 
-        x->right = y;
-        y->left = T2;
+    void replaceRoot(LeftistNode* newRoot) {
+        releaseNode(root, mem);
+        root = newRoot;
+    }
 
-        updateHeight(y);
-        updateHeight(x);
+public:
+    PersistentHeap(bool minHeap = true) : root(NULL), isMin(minHeap), mem(&heapMemory), versions(&mem) {}
 
-        return x;
+    ~PersistentHeap() {
+        releaseNode(root, mem);
+        versions.releaseAll();
     }
 
-    AVLNode* rotateLeft(AVLNode* x) {
-        lastRotation = "Left rotation on node " + intToString(x->data);
-        AVLNode* y = x->right;
-        AVLNode* T2 = y->left;
+    bool insert(int val) {
+        if (!memoryAvailable((rank(root) + 2) * sizeof(LeftistNode)))
+            return false;
+        LeftistNode* single = makeNode(val, NULL, NULL);
+        replaceRoot(merge(root, single));
+        releaseNode(single, mem);
+        return true;
+    }
 
-        y->left = x;
-        x->right = T2;
+    int extractTop() {
+        if (!root)
+            return -999999;
+        int top = root->data;
+        replaceRoot(merge(root->left, root->right));
+        return top;
+    }
 
-        updateHeight(x);
-        updateHeight(y);
+    int getTop() {
+        return root ? root->data : -999999;
+    }
 
-        return y;
+    int getSize() {
+        return count(root);
     }
 
-    AVLNode* insertion(AVLNode* node, int val) {
-        if (node == NULL) {
-            return new AVLNode(val);
-        }
+    bool getIsMinHeap() {
+        return isMin;
+    }
 
-        if (val < node->data) {
-            node->left = insertion(node->left, val);
+    // Level order of the leftist tree
+    string getArray() {
+        string result = "[";
+        int n = count(root);
+        if (n > 0) {
+            LeftistNode** order = new LeftistNode* [n];
+            int head = 0;
+            int tail = 0;
+            order[tail++] = root;
+            while (head < tail) {
+                LeftistNode* node = order[head++];
+                if (head > 1) result += ",";
+                result += intToString(node->data);
+                if (node->left) order[tail++] = node->left;
+                if (node->right) order[tail++] = node->right;
+            }
+            delete[] order;
         }
-        else if (val > node->data) {
-            node->right = insertion(node->right, val);
+        result += "]";
+        return result;
+    }
+
+    void clear() {
+        replaceRoot(NULL);
+    }
+
+    int snapshot() {
+        return versions.snapshot(root);
+    }
+
+    bool restore(int version) {
+        LeftistNode* saved;
+        if (!versions.find(version, saved))
+            return false;
+        retainNode(saved);
+        replaceRoot(saved);
+        return true;
+    }
+
+    bool releaseVersion(int version) {
+        return versions.release(version);
+    }
+
+    int getVersionCount() {
+        return versions.liveCount();
+    }
+
+    string getMemoryStats() {
+        return "[" + mem.toString() + "]";
+    }
+};
+
+// ===================== ADDRESSABLE HEAP (PAIRING) =====================
+// Pairing heap whose insert returns a handle that later reaches the item
+// directly: decreaseKey/increaseKey/erase are O(log n) amortized and meld
+// is O(1). Nodes of every AddressableHeap live in one shared pool; a
+// handle is the node's slot plus its generation, so handles stay valid when
+// heaps are melded and go stale when the item is removed. Each node is
+// tagged with its heap's id; meld joins ids with a union-find instead of
+// retagging the melded nodes. Ids are reference counted and recycled once
+// no node, joined id or heap refers to them.
+struct PairingNode {
+    int data;
+    int child;
+    int sibling;    // next sibling, or next free node
+    int prev;       // parent if first child, else left sibling; -1 for roots
+    int owner;      // heap id, -1 when free
+    int generation; // bumped on release; the high bits of the slot's handles
+};
+
+struct PairingHeapId {
+    int parent;     // union-find parent, or next free id
+    int refs;       // tagged nodes + ids joined into this one + owning heap
+};
+
+class PairingPool {
+private:
+    // A handle is slot | generation << SLOT_BITS, so a handle kept after
+    // erase() stops matching once the slot is reused (until the 11-bit
+    // generation wraps around)
+    static const int SLOT_BITS = 20;
+    static const int MAX_NODES = 1 << SLOT_BITS;
+    static const int GENERATION_MASK = (1 << 11) - 1;
+
+    int capacity;
+    int freshGeneration;
+    int freeList;
+    int liveNodes;
+    PairingHeapId* heapIds;
+    int heapCount;
+    int heapCapacity;
+    int freeHeaps;
+
+    template <typename T>
+    bool grow(T*& items, int& cap, int count) {
+        int grown = cap > 0 ? cap * 2 : 64;
+        if (!memoryAvailable((grown - cap) * sizeof(T)))
+            return false;
+        T* copy = new T[grown];
+        for (int i = 0; i < count; i++)
+            copy[i] = items[i];
+        delete[] items;
+        mem.remove(cap * sizeof(T));
+        items = copy;
+        cap = grown;
+        mem.add(cap * sizeof(T));
+        return true;
+    }
+
+public:
+    PairingNode* nodes;
+    MemoryStats mem;
+
+    PairingPool() : capacity(0), freshGeneration(0), freeList(-1), liveNodes(0), heapIds(NULL), heapCount(0), heapCapacity(0),
+        freeHeaps(-1), nodes(NULL), mem(&heapMemory) {}
+
+    ~PairingPool() {
+        delete[] nodes;
+        delete[] heapIds;
+    }
+
+    // Returns a slot, or -1 when the memory budget or the slot bits are
+    // exhausted
+    int allocate(int val, int owner) {
+        if (freeList == -1) {
+            int used = capacity;
+            if (capacity == MAX_NODES || !grow(nodes, capacity, used))
+                return -1;
+            for (int i = capacity - 1; i >= used; i--) {
+                nodes[i].owner = -1;
+                nodes[i].generation = freshGeneration;
+                nodes[i].sibling = freeList;
+                freeList = i;
+            }
         }
-        else {
+        int handle = freeList;
+        freeList = nodes[handle].sibling;
+        PairingNode& node = nodes[handle];
+        node.data = val;
+        node.child = -1;
+        node.sibling = -1;
+        node.prev = -1;
+        node.owner = owner;
+        heapIds[owner].refs++;
+        liveNodes++;
+        return handle;
+    }
+
+    // The pool is freed once every node is. Slots created afterwards start
+    // at a generation that moves on with every release, so handles from
+    // before are still unlikely to match.
+    void release(int slot) {
+        dropHeap(nodes[slot].owner);
+        nodes[slot].owner = -1;
+        nodes[slot].generation = (nodes[slot].generation + 1) & GENERATION_MASK;
+        nodes[slot].sibling = freeList;
+        freeList = slot;
+        freshGeneration = (freshGeneration + 1) & GENERATION_MASK;
+        if (--liveNodes == 0) {
+            delete[] nodes;
+            mem.remove(capacity * sizeof(PairingNode));
+            nodes = NULL;
+            capacity = 0;
+            freeList = -1;
+        }
+    }
+
+    // The new id is referenced by the heap that will use it. A recycled id
+    // cannot match a stale handle: its nodes were all released first.
+    int newHeap() {
+        int id = freeHeaps;
+        if (id != -1) {
+            freeHeaps = heapIds[id].parent;
+        } else {
+            if (heapCount == heapCapacity && !grow(heapIds, heapCapacity, heapCount))
+                return -1;
+            id = heapCount++;
+        }
+        heapIds[id].parent = id;
+        heapIds[id].refs = 1;
+        return id;
+    }
+
+    // Drops one reference; an id left with none is freed, which in turn
+    // drops its link to its union-find parent
+    void dropHeap(int id) {
+        while (--heapIds[id].refs == 0) {
+            int parent = heapIds[id].parent;
+            heapIds[id].parent = freeHeaps;
+            freeHeaps = id;
+            if (parent == id)
+                return;
+            id = parent;
+        }
+    }
+
+    int findHeap(int id) {
+        while (heapIds[id].parent != id) {
+            int parent = heapIds[id].parent;
+            int grandparent = heapIds[parent].parent;
+            if (grandparent != parent) {
+                heapIds[id].parent = grandparent;
+                heapIds[grandparent].refs++;
+                dropHeap(parent);
+            }
+            id = grandparent;
+        }
+        return id;
+    }
+
+    // from's heap gives up its reference; its nodes now resolve to into
+    void joinHeap(int from, int into) {
+        heapIds[from].parent = into;
+        heapIds[into].refs++;
+        dropHeap(from);
+    }
+
+    int handleOf(int slot) {
+        return slot | nodes[slot].generation << SLOT_BITS;
+    }
+
+    // The slot of a live item of heap id, or -1 for a handle of another
+    // heap or of an item that was already removed
+    int resolve(int id, int handle) {
+        if (id < 0 || handle < 0)
+            return -1;
+        int slot = handle & (MAX_NODES - 1);
+        if (slot >= capacity || nodes[slot].owner < 0 || nodes[slot].generation != handle >> SLOT_BITS ||
+            findHeap(nodes[slot].owner) != id)
+            return -1;
+        return slot;
+    }
+};
+
+PairingPool pairingPool;
+
+class AddressableHeap {
+private:
+    int root;
+    int size;
+    int id;
+    bool isMin;
+    // Bytes of this heap's nodes; the pool's arrays are charged to heapMemory
+    MemoryStats mem;
+
+    PairingNode& at(int slot) {
+        return pairingPool.nodes[slot];
+    }
+
+    bool before(int a, int b) {
+        return isMin ? a <= b : a >= b;
+    }
+
+    // Links two roots; the loser becomes the winner's first child
+    int link(int a, int b) {
+        if (a == -1) return b;
+        if (b == -1) return a;
+        if (!before(at(a).data, at(b).data)) {
+            int t = a;
+            a = b;
+            b = t;
+        }
+        at(b).sibling = at(a).child;
+        if (at(a).child != -1)
+            at(at(a).child).prev = b;
+        at(b).prev = a;
+        at(a).child = b;
+        return a;
+    }
+
+    // Detaches a non-root node (with its subtree) from its parent
+    void cut(int handle) {
+        PairingNode& node = at(handle);
+        if (at(node.prev).child == handle)
+            at(node.prev).child = node.sibling;
+        else
+            at(node.prev).sibling = node.sibling;
+        if (node.sibling != -1)
+            at(node.sibling).prev = node.prev;
+        node.prev = -1;
+        node.sibling = -1;
+    }
+
+    // Two-pass pairing of a sibling list into one tree
+    int mergePairs(int first) {
+        int pairs = -1;
+        while (first != -1) {
+            int a = first;
+            int b = at(a).sibling;
+            first = b != -1 ? at(b).sibling : -1;
+            at(a).prev = -1;
+            at(a).sibling = -1;
+            if (b != -1) {
+                at(b).prev = -1;
+                at(b).sibling = -1;
+            }
+            int winner = link(a, b);
+            at(winner).sibling = pairs;
+            pairs = winner;
+        }
+
+        int merged = -1;
+        while (pairs != -1) {
+            int next = at(pairs).sibling;
+            at(pairs).sibling = -1;
+            merged = link(merged, pairs);
+            pairs = next;
+        }
+        return merged;
+    }
+
+    // Re-positions an item after its key changed
+    void setKey(int handle, int val) {
+        bool improves = before(val, at(handle).data);
+        at(handle).data = val;
+        if (improves) {
+            if (handle != root) {
+                cut(handle);
+                root = link(root, handle);
+            }
+            return;
+        }
+
+        // A worse key may lose to its own children: re-pair them
+        int children = at(handle).child;
+        at(handle).child = -1;
+        if (handle == root)
+            root = -1;
+        else
+            cut(handle);
+        root = link(link(root, handle), mergePairs(children));
+    }
+
+public:
+    AddressableHeap(bool minHeap = true) : root(-1), size(0), isMin(minHeap) {
+        id = pairingPool.newHeap();
+    }
+
+    ~AddressableHeap() {
+        clear();
+        if (id != -1)
+            pairingPool.dropHeap(id);
+    }
+
+    // Returns the item's handle, or -1 when out of memory
+    int insert(int val) {
+        if (id == -1)
+            return -1;
+        int slot = pairingPool.allocate(val, id);
+        if (slot == -1)
+            return -1;
+        mem.add(sizeof(PairingNode));
+        root = link(root, slot);
+        size++;
+        return pairingPool.handleOf(slot);
+    }
+
+    int getTop() {
+        return root != -1 ? at(root).data : -999999;
+    }
+
+    int getTopHandle() {
+        return root != -1 ? pairingPool.handleOf(root) : -1;
+    }
+
+    int extractTop() {
+        if (root == -1)
+            return -999999;
+        int top = root;
+        int val = at(top).data;
+        root = mergePairs(at(top).child);
+        pairingPool.release(top);
+        mem.remove(sizeof(PairingNode));
+        size--;
+        return val;
+    }
+
+    // Moves the item towards the top (val <= current in a min-heap)
+    bool decreaseKey(int handle, int val) {
+        int slot = pairingPool.resolve(id, handle);
+        if (slot == -1 || (isMin ? val > at(slot).data : val < at(slot).data))
+            return false;
+        setKey(slot, val);
+        return true;
+    }
+
+    // Moves the item away from the top (val >= current in a min-heap)
+    bool increaseKey(int handle, int val) {
+        int slot = pairingPool.resolve(id, handle);
+        if (slot == -1 || (isMin ? val < at(slot).data : val > at(slot).data))
+            return false;
+        setKey(slot, val);
+        return true;
+    }
+
+    bool erase(int handle) {
+        int slot = pairingPool.resolve(id, handle);
+        if (slot == -1)
+            return false;
+        if (slot == root) {
+            extractTop();
+            return true;
+        }
+        cut(slot);
+        root = link(root, mergePairs(at(slot).child));
+        pairingPool.release(slot);
+        mem.remove(sizeof(PairingNode));
+        size--;
+        return true;
+    }
+
+    bool contains(int handle) {
+        return pairingPool.resolve(id, handle) != -1;
+    }
+
+    int getValue(int handle) {
+        int slot = pairingPool.resolve(id, handle);
+        return slot != -1 ? at(slot).data : -999999;
+    }
+
+    // Moves every item of other into this heap in O(1); their handles stay
+    // valid here and other is left empty
+    bool meld(AddressableHeap* other) {
+        if (other == NULL || other == this || other->isMin != isMin || id == -1)
+            return false;
+        int fresh = pairingPool.newHeap();
+        if (fresh == -1)
+            return false;
+        if (other->id != -1)
+            pairingPool.joinHeap(other->id, id);
+        root = link(root, other->root);
+        size += other->size;
+        int moved = other->mem.liveBytes;
+        if (moved > 0) {
+            mem.add(moved);
+            other->mem.remove(moved);
+        }
+        other->root = -1;
+        other->size = 0;
+        other->id = fresh;
+        return true;
+    }
+
+    int getSize() {
+        return size;
+    }
+
+    bool getIsMinHeap() {
+        return isMin;
+    }
+
+    // Level order of the pairing tree
+    string getArray() {
+        string result = "[";
+        if (size > 0) {
+            int* order = new int[size];
+            int head = 0;
+            int tail = 0;
+            order[tail++] = root;
+            while (head < tail) {
+                int handle = order[head++];
+                if (head > 1) result += ",";
+                result += intToString(at(handle).data);
+                for (int c = at(handle).child; c != -1; c = at(c).sibling)
+                    order[tail++] = c;
+            }
+            delete[] order;
+        }
+        result += "]";
+        return result;
+    }
+
+    void clear() {
+        // Walk the tree using prev as the pending list; children are all
+        // queued before any of them is released
+        int pending = root;
+        if (pending != -1)
+            at(pending).prev = -1;
+        while (pending != -1) {
+            int handle = pending;
+            pending = at(handle).prev;
+            for (int c = at(handle).child; c != -1; c = at(c).sibling) {
+                at(c).prev = pending;
+                pending = c;
+            }
+            pairingPool.release(handle);
+        }
+        mem.remove(mem.liveBytes);
+        root = -1;
+        size = 0;
+    }
+
+    string getMemoryStats() {
+        return "[" + mem.toString() + "]";
+    }
+};
+
+// ===================== FROZEN SEARCH INDEX =====================
+// Read-only sorted keys in Eytzinger (BFS) order: keys[1] is the root and
+// the children of k are 2k and 2k+1, so the top levels share cache lines
+// and a search is a branch-free walk down the array. Built by
+// AVLTree::freeze() for lookup-heavy workloads.
+class FrozenIndex {
+private:
+    int* keys;
+    int n;
+    int levels;
+    int* results;
+    int resultCapacity;
+    MemoryStats mem;
+
+    int fill(const int* sorted, int i, int k) {
+        if (k <= n) {
+            i = fill(sorted, i, 2 * k);
+            keys[k] = sorted[i++];
+            i = fill(sorted, i, 2 * k + 1);
+        }
+        return i;
+    }
+
+    // The walk ends past the leaves; dropping the trailing right turns and
+    // the last left turn gives the first key >= val (0 if none)
+    int settle(int k) {
+        return k >> __builtin_ffs(~k);
+    }
+
+public:
+    FrozenIndex(const int* sorted, int count) : n(count), levels(0), results(NULL), resultCapacity(0), mem(&avlMemory) {
+        keys = new int[n + 1];
+        keys[0] = 0;
+        mem.add((n + 1) * sizeof(int));
+        fill(sorted, 0, 1);
+        while ((1 << levels) <= n)
+            levels++;
+    }
+
+    ~FrozenIndex() {
+        delete[] keys;
+        delete[] results;
+        mem.remove((n + 1 + resultCapacity) * sizeof(int));
+    }
+
+    static int bytesFor(int count) {
+        return (count + 1) * sizeof(int);
+    }
+
+    // Position of the first key >= val, 0 if every key is smaller
+    int lowerBoundIndex(int val) {
+        int k = 1;
+        while (k <= n) {
+            // 16 ints ahead is the cache line holding the 4th level below k
+            __builtin_prefetch(keys + 16 * k);
+            k = 2 * k + (keys[k] < val);
+        }
+        return settle(k);
+    }
+
+    int lowerBound(int val) {
+        int k = lowerBoundIndex(val);
+        return k ? keys[k] : -999999;
+    }
+
+    bool contains(int val) {
+        int k = lowerBoundIndex(val);
+        return k != 0 && keys[k] == val;
+    }
+
+    // Looks up count values, writing 1/0 per value to found, and returns
+    // the number found. Groups of queries walk down level by level so
+    // their cache misses overlap.
+    int findBatch(const int* queries, int count, int* found) {
+        const int GROUP = 8;
+        int hits = 0;
+        int i = 0;
+        for (; i + GROUP <= count; i += GROUP) {
+            int k[GROUP];
+            for (int g = 0; g < GROUP; g++)
+                k[g] = 1;
+            for (int level = 0; level < levels; level++) {
+                for (int g = 0; g < GROUP; g++) {
+                    // Paths that already left the tree stay put
+                    int key = keys[k[g] <= n ? k[g] : 0];
+                    int next = 2 * k[g] + (key < queries[i + g]);
+                    k[g] = k[g] <= n ? next : k[g];
+                }
+            }
+            for (int g = 0; g < GROUP; g++) {
+                int pos = settle(k[g]);
+                found[i + g] = pos != 0 && keys[pos] == queries[i + g];
+                hits += found[i + g];
+            }
+        }
+        for (; i < count; i++) {
+            found[i] = contains(queries[i]);
+            hits += found[i];
+        }
+        return hits;
+    }
+
+#ifdef __EMSCRIPTEN__
+    // Copies the Int32Array in chunks; the returned view of 1/0 flags is
+    // valid until the next call
+    val findMany(val queries) {
+        int length = queries["length"].as<int>();
+        if (length > resultCapacity) {
+            if (!memoryAvailable((length - resultCapacity) * sizeof(int)))
+                return val(typed_memory_view(0, results));
+            delete[] results;
+            mem.remove(resultCapacity * sizeof(int));
+            results = new int[length];
+            resultCapacity = length;
+            mem.add(resultCapacity * sizeof(int));
+        }
+
+        const int CHUNK = 1024;
+        int chunk[CHUNK];
+        for (int start = 0; start < length; start += CHUNK) {
+            int count = length - start < CHUNK ? length - start : CHUNK;
+            val(typed_memory_view(count, chunk)).call<void>("set", queries.call<val>("subarray", start, start + count));
+            findBatch(chunk, count, results + start);
+        }
+        return val(typed_memory_view(length, results));
+    }
+#endif
+
+    int getSize() {
+        return n;
+    }
+
+    string getMemoryStats() {
+        return "[" + mem.toString() + "]";
+    }
+};
+
+// ===================== 2. AVL TREE =====================
+struct AVLNode {
+    int data;
+    AVLNode* left;
+    AVLNode* right;
+    int height;
+    int refs;
+
+    AVLNode(int val) : data(val), left(NULL), right(NULL), height(1), refs(1) {}
+};
+
+// ===================== ROTATION LOG =====================
+// The most recent AVL rotations as fixed-size records, formatted to text
+// only when asked for
+enum RotationKind {
+    ROTATION_LEFT,
+    ROTATION_RIGHT,
+    ROTATION_LEFT_RIGHT,
+    ROTATION_RIGHT_LEFT
+};
+
+class RotationLog {
+private:
+    static const int CAPACITY = 32;
+
+    struct Record {
+        int kind;
+        int pivot;
+    };
+
+    Record records[CAPACITY];
+    int total;
+    int operationStart;
+
+    static string format(const Record& record) {
+        switch (record.kind) {
+        case ROTATION_LEFT:
+            return "Left rotation on node " + intToString(record.pivot);
+        case ROTATION_RIGHT:
+            return "Right rotation on node " + intToString(record.pivot);
+        case ROTATION_LEFT_RIGHT:
+            return "Left-Right rotation (LR) on node " + intToString(record.pivot);
+        default:
+            return "Right-Left rotation (RL) on node " + intToString(record.pivot);
+        }
+    }
+
+public:
+    RotationLog() : total(0), operationStart(0) {}
+
+    // Marks the start of an insert/remove for getLast()
+    void beginOperation() {
+        operationStart = total;
+    }
+
+    void record(int kind, int pivot) {
+        Record& slot = records[total % CAPACITY];
+        slot.kind = kind;
+        slot.pivot = pivot;
+        total++;
+    }
+
+    // Last rotation of the latest operation
+    string getLast() {
+        if (total == operationStart)
+            return "No rotations performed";
+        return format(records[(total - 1) % CAPACITY]);
+    }
+
+    // Oldest first, up to the last CAPACITY rotations
+    string getHistory() {
+        string result = "[";
+        int first = total > CAPACITY ? total - CAPACITY : 0;
+        for (int i = first; i < total; i++) {
+            if (i > first) result += ",";
+            result += format(records[i % CAPACITY]);
+        }
+        result += "]";
+        return result;
+    }
+};
+
+class AVLTree {
+private:
+    AVLNode* root;
+    RotationLog rotations;
+    MemoryStats mem;
+    TraceLog* trace;
+    VersionTable<AVLNode> versions;
+    int logId;
+    int logGeneration;
+    ChangeSet changes;
+
+    // Records the keys in level order. Replaying them inserts every key
+    // below its final parent without triggering a rotation, so the replayed
+    // tree has exactly this shape (preorder would not).
+    void logSubtree(AVLNode* node) {
+        if (!node)
+            return;
+        int count = countNodes(node);
+        AVLNode** queue = new AVLNode* [count];
+        int head = 0, tail = 0;
+        queue[tail++] = node;
+        while (head < tail) {
+            AVLNode* current = queue[head++];
+            opLog.record(OP_AVL_INSERT, logId, current->data);
+            if (current->left) queue[tail++] = current->left;
+            if (current->right) queue[tail++] = current->right;
+        }
+        delete[] queue;
+    }
+
+    int logTarget() {
+        if (!opLog.owns(logId, logGeneration)) {
+            logId = opLog.newTarget(logGeneration);
+            opLog.record(OP_CREATE_AVL, logId);
+            logSubtree(root);
+        }
+        return logId;
+    }
+
+    // Changes the log cannot express (e.g. restore) end the old target;
+    // the next call re-creates it from the current contents
+    void logResync() {
+        if (opLog.recording && opLog.owns(logId, logGeneration))
+            opLog.record(OP_DESTROY, logId);
+        logId = -1;
+    }
+
+    int max(int a, int b) {
+        return (a > b) ? a : b;
+    }
+
+    int height(AVLNode* node) {
+        return (node) ? node->height : 0;
+    }
+
+    void updateHeight(AVLNode* node) {
+        if (node) {
+            node->height = 1 + max(height(node->left), height(node->right));
+        }
+    }
+
+    int getBalance(AVLNode* node) {
+        return node ? height(node->left) - height(node->right) : 0;
+    }
+
+    // Path copying: a node shared with a saved version is cloned before it
+    // is modified. The caller's link to node becomes the link to the copy.
+    AVLNode* own(AVLNode* node) {
+        if (node == NULL || node->refs == 1)
             return node;
+        node->refs--;
+        AVLNode* copy = new AVLNode(*node);
+        mem.add(sizeof(AVLNode));
+        copy->refs = 1;
+        retainNode(copy->left);
+        retainNode(copy->right);
+        return copy;
+    }
+
+    AVLNode* rotateRight(AVLNode* y) {
+        if (trace)
+            trace->record(TRACE_ROTATE, 1, y->data);
+        AVLNode* x = own(y->left);
+        AVLNode* T2 = x->right;
+
+        x->right = y;
+        y->left = T2;
+
+        updateHeight(y);
+        updateHeight(x);
+        changes.add(x->data);
+        changes.add(y->data);
+
+        return x;
+    }
+
+    AVLNode* rotateLeft(AVLNode* x) {
+        if (trace)
+            trace->record(TRACE_ROTATE, 0, x->data);
+        AVLNode* y = own(x->right);
+        AVLNode* T2 = y->left;
+
+        y->left = x;
+        x->right = T2;
+
+        updateHeight(x);
+        updateHeight(y);
+        changes.add(x->data);
+        changes.add(y->data);
+
+        return y;
+    }
+
+    // Restores |balance| <= 1 at an owned node and returns the new
+    // subtree root
+    AVLNode* rebalance(AVLNode* node) {
+        if (getBalance(node) > 1) {
+            if (getBalance(node->left) >= 0) {
+                rotations.record(ROTATION_RIGHT, node->data);
+                return rotateRight(node);
+            }
+            rotations.record(ROTATION_LEFT_RIGHT, node->data);
+            node->left = rotateLeft(own(node->left));
+            return rotateRight(node);
+        }
+
+        if (getBalance(node->right) <= 0) {
+            rotations.record(ROTATION_LEFT, node->data);
+            return rotateLeft(node);
+        }
+        rotations.record(ROTATION_RIGHT_LEFT, node->data);
+        node->right = rotateRight(own(node->right));
+        return rotateLeft(node);
+    }
+
+    AVLNode* find(int val) {
+        AVLNode* node = root;
+        while (node && node->data != val)
+            node = val < node->data ? node->left : node->right;
+        return node;
+    }
+
+    // Search path of an insert/remove. An AVL tree of 2^31 nodes is at
+    // most 45 levels high.
+    static const int MAX_HEIGHT = 64;
+
+    struct Path {
+        AVLNode* nodes[MAX_HEIGHT];
+        bool wentLeft[MAX_HEIGHT];
+        int oldBalance[MAX_HEIGHT];
+        int depth;
+
+        Path() : depth(0) {}
+    };
+
+    // Walks from the root towards val without touching the tree, so a
+    // duplicate insert or a missing remove leaves it, and any versions
+    // sharing its nodes, as they were. Returns the node holding val, or
+    // NULL; the path ends above it.
+    AVLNode* search(Path& path, int val) {
+        AVLNode* node = root;
+        while (node && node->data != val) {
+            path.nodes[path.depth++] = node;
+            node = val < node->data ? node->left : node->right;
+        }
+        return node;
+    }
+
+    // Called once the operation will change the tree: notes each level's
+    // direction and balance, and copies the path and tail (the node below
+    // its last level, if any) where they are shared with saved versions.
+    // Returns the tail as owned by this tree.
+    AVLNode* ownPath(Path& path, AVLNode* tail, int val) {
+        for (int i = 0; i < path.depth; i++) {
+            AVLNode* node = path.nodes[i];
+            AVLNode* next = i + 1 < path.depth ? path.nodes[i + 1] : tail;
+            path.wentLeft[i] = next ? next == node->left : val < node->data;
+            path.oldBalance[i] = getBalance(node);
+            if (node->refs != 1) {
+                path.nodes[i] = own(node);
+                attach(path, i, path.nodes[i]);
+            }
+        }
+        if (tail && tail->refs != 1) {
+            tail = own(tail);
+            attach(path, path.depth, tail);
+        }
+        return tail;
+    }
+
+    // Links node where path level i points (the root for i == 0)
+    void attach(Path& path, int i, AVLNode* node) {
+        if (i == 0)
+            root = node;
+        else if (path.wentLeft[i - 1])
+            path.nodes[i - 1]->left = node;
+        else
+            path.nodes[i - 1]->right = node;
+    }
+
+    // Walks back up fixing heights and balance; stops as soon as a
+    // subtree keeps its old height since nothing above can change
+    void retrace(Path& path) {
+        for (int i = path.depth - 1; i >= 0; i--) {
+            AVLNode* node = path.nodes[i];
+            int oldHeight = node->height;
+            updateHeight(node);
+            int balance = getBalance(node);
+            if (node->height != oldHeight || balance != path.oldBalance[i])
+                changes.add(node->data);
+
+            if (balance > 1 || balance < -1) {
+                node = rebalance(node);
+                attach(path, i, node);
+            }
+            if (node->height == oldHeight)
+                return;
         }
+    }
+
+    void insertion(int val) {
+        Path path;
+        if (search(path, val))
+            return;
+
+        ownPath(path, NULL, val);
+        changes.add(val);
+        mem.add(sizeof(AVLNode));
+        attach(path, path.depth, new AVLNode(val));
+        retrace(path);
+    }
+
+    void deleteNode(int val) {
+        Path path;
+        AVLNode* node = search(path, val);
+        if (!node)
+            return;
+
+        // Two children: take the in-order successor's value and remove
+        // the successor instead
+        int target = -1;
+        if (node->left && node->right) {
+            target = path.depth;
+            path.nodes[path.depth++] = node;
+            node = node->right;
+            while (node->left) {
+                path.nodes[path.depth++] = node;
+                node = node->left;
+            }
+        }
+        node = ownPath(path, node, val);
+        if (target != -1) {
+            changes.add(path.nodes[target]->data);
+            path.nodes[target]->data = node->data;
+        }
+
+        // The remaining child is already balanced and takes over node's
+        // link, so it may stay shared.
+        AVLNode* child = node->left ? node->left : node->right;
+        changes.add(node->data);
+        delete node;
+        mem.remove(sizeof(AVLNode));
+        attach(path, path.depth, child);
+        retrace(path);
+    }
+
+    int countNodes(AVLNode* node) {
+        return node ? 1 + countNodes(node->left) + countNodes(node->right) : 0;
+    }
+
+    int collectKeys(AVLNode* node, int* keys, int i) {
+        if (!node)
+            return i;
+        i = collectKeys(node->left, keys, i);
+        keys[i++] = node->data;
+        return collectKeys(node->right, keys, i);
+    }
+
+    void inorderTraversal(AVLNode* node, string& result, bool& first) {
+        if (!node) 
+            return;
+        inorderTraversal(node->left, result, first);
+        if (!first) result += ",";
+        first = false;
+        result += intToString(node->data) + ":" +
+            intToString(node->height) + ":" +
+            intToString(getBalance(node));
+        inorderTraversal(node->right, result, first);
+    }
+
+public:
+    AVLTree() : root(NULL), mem(&avlMemory), trace(NULL), versions(&mem), logId(-1), logGeneration(0) {}
+
+    ~AVLTree() {
+        logResync();
+        releaseNode(root, mem);
+        versions.releaseAll();
+        disableTrace();
+    }
+
+    bool insert(int val) {
+        if (opLog.recording)
+            opLog.record(OP_AVL_INSERT, logTarget(), val);
+        rotations.beginOperation();
+        // With saved versions, the whole search path may be copied
+        int nodes = versions.liveCount() > 0 ? height(root) + 2 : 1;
+        if (!memoryAvailable(nodes * sizeof(AVLNode)))
+            return false;
+        insertion(val);
+        return true;
+    }
+
+    void remove(int val) {
+        if (opLog.recording)
+            opLog.record(OP_AVL_REMOVE, logTarget(), val);
+        rotations.beginOperation();
+        deleteNode(val);
+    }
+
+    string getTree() {
+        if (opLog.recording)
+            opLog.record(OP_AVL_GET_TREE, logTarget());
+        string result = "[";
+        bool first = true;
+        inorderTraversal(root, result, first);
+        result += "]";
+        return result;
+    }
+
+    string getLastRotation() {
+        return rotations.getLast();
+    }
+
+    string getRotationHistory() {
+        return rotations.getHistory();
+    }
+
+    bool contains(int val) {
+        if (opLog.recording)
+            opLog.record(OP_AVL_CONTAINS, logTarget(), val);
+        return find(val) != NULL;
+    }
+
+    // Read-only snapshot of the keys for fast lookups; later changes to
+    // the tree are not reflected. The caller deletes it. NULL when the
+    // memory budget is exhausted.
+    FrozenIndex* freeze() {
+        int n = countNodes(root);
+        if (!memoryAvailable(2 * FrozenIndex::bytesFor(n)))
+            return NULL;
+        int* sorted = new int[n + 1];
+        collectKeys(root, sorted, 0);
+        FrozenIndex* index = new FrozenIndex(sorted, n);
+        delete[] sorted;
+        return index;
+    }
+
+    void clear() {
+        if (opLog.recording)
+            opLog.record(OP_AVL_CLEAR, logTarget());
+        releaseNode(root, mem);
+        root = NULL;
+        rotations.beginOperation();
+        changes.markAll();
+    }
+
+    // O(1): the saved root shares every node with the live tree
+    int snapshot() {
+        return versions.snapshot(root);
+    }
+
+    bool restore(int version) {
+        AVLNode* saved;
+        if (!versions.find(version, saved))
+            return false;
+        retainNode(saved);
+        releaseNode(root, mem);
+        root = saved;
+        logResync();
+        changes.markAll();
+        return true;
+    }
+
+    bool releaseVersion(int version) {
+        return versions.release(version);
+    }
+
+    int getVersionCount() {
+        return versions.liveCount();
+    }
+
+#ifdef __EMSCRIPTEN__
+    val getChanges() {
+        return changes.view();
+    }
+#endif
+
+    void resetChanges() {
+        changes.reset();
+    }
+
+    string getMemoryStats() {
+        return "[" + mem.toString() + "]";
+    }
+
+    bool enableTrace(int capacity) {
+        disableTrace();
+        if (capacity <= 0 || capacity > TraceLog::MAX_CAPACITY || !memoryAvailable(TraceLog::bytesFor(capacity)))
+            return false;
+        trace = new TraceLog(capacity);
+        mem.add(trace->bytes());
+        return true;
+    }
+
+    void disableTrace() {
+        if (trace) {
+            mem.remove(trace->bytes());
+            delete trace;
+            trace = NULL;
+        }
+    }
+
+    void clearTrace() {
+        if (trace)
+            trace->clear();
+    }
+
+#ifdef __EMSCRIPTEN__
+    val getTrace() {
+        return trace ? trace->view() : val(typed_memory_view(0, (int*)NULL));
+    }
+#endif
+
+    int getTraceDropped() {
+        return trace ? trace->getDropped() : 0;
+    }
+};
+
+// ===================== BARNES-HUT QUADTREE =====================
+// Quadtree over the layout positions used to approximate vertex repulsion
+// in O(n log n). Cells live in parallel arrays (SoA); children of cell c
+// are child[4c..4c+3], -1 for a leaf.
+class QuadTree {
+private:
+    static const int MAX_DEPTH = 24;
+
+    int capacity;
+    int count;
+    float* mass;
+    float* comX;
+    float* comY;
+    float* centerX;
+    float* centerY;
+    float* half;
+    int* body;
+    int* child;
+    MemoryStats* mem;
+
+    void allocate(int cells) {
+        mass = new float[cells];
+        comX = new float[cells];
+        comY = new float[cells];
+        centerX = new float[cells];
+        centerY = new float[cells];
+        half = new float[cells];
+        body = new int[cells];
+        child = new int[cells * 4];
+        capacity = cells;
+        mem->add(bytesFor(cells));
+    }
+
+    template <typename T>
+    static T* copyGrown(T* old, int oldCount, int newCount) {
+        T* grown = new T[newCount];
+        for (int i = 0; i < oldCount; i++) grown[i] = old[i];
+        delete[] old;
+        return grown;
+    }
+
+    // Fails, leaving the pool as it was, when the memory budget refuses
+    bool grow(int cells) {
+        if (cells > MAX_CELLS || !memoryAvailable(bytesFor(cells) - bytesFor(capacity)))
+            return false;
+        mass = copyGrown(mass, count, cells);
+        comX = copyGrown(comX, count, cells);
+        comY = copyGrown(comY, count, cells);
+        centerX = copyGrown(centerX, count, cells);
+        centerY = copyGrown(centerY, count, cells);
+        half = copyGrown(half, count, cells);
+        body = copyGrown(body, count, cells);
+        child = copyGrown(child, count * 4, cells * 4);
+        mem->add(bytesFor(cells) - bytesFor(capacity));
+        capacity = cells;
+        return true;
+    }
+
+    void release() {
+        delete[] mass;
+        delete[] comX;
+        delete[] comY;
+        delete[] centerX;
+        delete[] centerY;
+        delete[] half;
+        delete[] body;
+        delete[] child;
+        mem->remove(bytesFor(capacity));
+    }
+
+    int newCell(float cx, float cy, float h) {
+        int c = count++;
+        mass[c] = 0;
+        comX[c] = 0;
+        comY[c] = 0;
+        centerX[c] = cx;
+        centerY[c] = cy;
+        half[c] = h;
+        body[c] = -1;
+        for (int q = 0; q < 4; q++) child[c * 4 + q] = -1;
+        return c;
+    }
+
+    int quadrant(int c, float x, float y) {
+        return (x >= centerX[c] ? 1 : 0) + (y >= centerY[c] ? 2 : 0);
+    }
+
+    bool subdivide(int c) {
+        if (count + 4 > capacity && !grow(capacity * 2))
+            return false;
+        float h = half[c] / 2;
+        for (int q = 0; q < 4; q++) {
+            float cx = centerX[c] + ((q & 1) ? h : -h);
+            float cy = centerY[c] + ((q & 2) ? h : -h);
+            child[c * 4 + q] = newCell(cx, cy, h);
+        }
+        return true;
+    }
+
+    bool insert(int b, const float* x, const float* y) {
+        int c = 0;
+        for (int depth = 0; ; depth++) {
+            if (mass[c] == 0) {
+                body[c] = b;
+                mass[c] = 1;
+                comX[c] = x[b];
+                comY[c] = y[b];
+                return true;
+            }
+
+            float m = mass[c];
+            comX[c] = (comX[c] * m + x[b]) / (m + 1);
+            comY[c] = (comY[c] * m + y[b]) / (m + 1);
+            mass[c] = m + 1;
+
+            if (child[c * 4] == -1) {
+                // Coincident vertices past MAX_DEPTH share one leaf
+                if (depth >= MAX_DEPTH)
+                    return true;
+                if (!subdivide(c))
+                    return false;
+                int existing = body[c];
+                body[c] = -1;
+                int e = child[c * 4 + quadrant(c, x[existing], y[existing])];
+                body[e] = existing;
+                mass[e] = 1;
+                comX[e] = x[existing];
+                comY[e] = y[existing];
+            }
+            c = child[c * 4 + quadrant(c, x[b], y[b])];
+        }
+    }
+
+public:
+    static const int INITIAL_CELLS = 64;
+    static const int MAX_CELLS = INT_MAX / (6 * sizeof(float) + 5 * sizeof(int));
+
+    static int bytesFor(int cells) {
+        return cells * (6 * sizeof(float) + 5 * sizeof(int));
+    }
+
+    QuadTree(MemoryStats* mem) : capacity(0), count(0), mem(mem) {
+        allocate(INITIAL_CELLS);
+    }
+
+    ~QuadTree() {
+        release();
+    }
+
+    // The pool keeps its size between builds and doubles when a build
+    // needs more cells. Returns false, with the tree unusable until the
+    // next build, if the memory budget refuses to grow it.
+    bool build(const float* x, const float* y, int n) {
+
+        float minX = x[0], maxX = x[0], minY = y[0], maxY = y[0];
+        for (int i = 1; i < n; i++) {
+            if (x[i] < minX) minX = x[i];
+            if (x[i] > maxX) maxX = x[i];
+            if (y[i] < minY) minY = y[i];
+            if (y[i] > maxY) maxY = y[i];
+        }
+        float h = (maxX - minX > maxY - minY ? maxX - minX : maxY - minY) / 2 + 1e-3f;
+
+        count = 0;
+        newCell((minX + maxX) / 2, (minY + maxY) / 2, h);
+        for (int i = 0; i < n; i++) {
+            if (!insert(i, x, y))
+                return false;
+        }
+        return true;
+    }
+
+    // Accumulates the k2/d repulsion on vertex i into fx, fy. Cells whose
+    // width/distance is below theta are treated as a single mass.
+    void repulse(int i, float xi, float yi, float k2, float theta, float& fx, float& fy) {
+        int stack[4 * MAX_DEPTH + 4];
+        int top = 0;
+        stack[top++] = 0;
+
+        while (top > 0) {
+            int c = stack[--top];
+            float m = mass[c];
+            if (m == 0)
+                continue;
+
+            float dx = xi - comX[c];
+            float dy = yi - comY[c];
+            float d2 = dx * dx + dy * dy;
+
+            if (child[c * 4] != -1) {
+                float width = 2 * half[c];
+                if (width * width >= theta * theta * d2) {
+                    for (int q = 0; q < 4; q++) stack[top++] = child[c * 4 + q];
+                    continue;
+                }
+            }
+            else if (body[c] == i) {
+                m -= 1;
+                if (m == 0)
+                    continue;
+            }
+
+            if (d2 < 1e-4f) {
+                // Nudge coincident vertices apart deterministically
+                dx = (i & 1) ? 0.01f : -0.01f;
+                dy = (i & 2) ? 0.01f : -0.01f;
+                d2 = 2e-4f;
+            }
+            float f = k2 * m / d2;
+            fx += dx * f;
+            fy += dy * f;
+        }
+    }
+};
+
+// ===================== 3. GRAPH (ADJACENCY MATRIX) =====================
+class Graph {
+private:
+    int n;
+    int** adjMatrix;
+    bool isDirected;
+    // Bumped on every change to the edges or direction, so copies held
+    // elsewhere (e.g. the worker's mirror) can tell they are stale
+    int revision;
+    MemoryStats mem;
+    TraceLog* trace;
+
+    // Streaming import state
+    static const int MAX_IMPORT_VERTICES = 2048;
+    string importCarry;
+    int importEdges;
+    int importRejected;
+    int importVertices;
+    bool importOneBased;
+    int logId;
+    int logGeneration;
+    ChangeSet changes;
+
+    // Force-directed layout state: layoutPos holds x[0..n) then y[0..n)
+    int layoutN;
+    float* layoutPos;
+    float* layoutDisp;
+    float temperature;
+    QuadTree* quadTree;
+    // Edge list the layout iterates: (u, v) pairs rebuilt from the matrix
+    // only when `revision` moves past edgeRevision
+    int* edgeList;
+    int edgeCount;
+    int edgeRevision;
+
+    static int layoutBytes(int vertices) {
+        return 4 * vertices * sizeof(float);
+    }
 
-        updateHeight(node);
-        int balance = getBalance(node);
+    static int edgeListBytes(int edges) {
+        return 2 * edges * sizeof(int);
+    }
 
-        // LL Case
-        if (balance > 1 && val < node->left->data) {
-            return rotateRight(node);
+    void freeEdgeList() {
+        if (edgeList) {
+            delete[] edgeList;
+            mem.remove(edgeListBytes(edgeCount));
+            edgeList = NULL;
         }
+        edgeCount = 0;
+        edgeRevision = -1;
+    }
 
-        // RR Case
-        if (balance < -1 && val > node->right->data) {
-            return rotateLeft(node);
+    bool syncEdgeList() {
+        if (edgeRevision == revision)
+            return true;
+        int count = 0;
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                if (adjMatrix[i][j] != 0 && i != j && (isDirected || i < j)) count++;
+            }
         }
-
-        // LR Case
-        if (balance > 1 && val > node->left->data) {
-            lastRotation = "Left-Right rotation (LR) on node " + intToString(node->data);
-            node->left = rotateLeft(node->left);
-            return rotateRight(node);
+        freeEdgeList();
+        if (!memoryAvailable(edgeListBytes(count)))
+            return false;
+        edgeList = new int[2 * count + 1];
+        edgeCount = count;
+        mem.add(edgeListBytes(count));
+        int e = 0;
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                if (adjMatrix[i][j] != 0 && i != j && (isDirected || i < j)) {
+                    edgeList[e++] = i;
+                    edgeList[e++] = j;
+                }
+            }
         }
+        edgeRevision = revision;
+        return true;
+    }
 
-        // RL Case
-        if (balance < -1 && val < node->right->data) {
-            lastRotation = "Right-Left rotation (RL) on node " + intToString(node->data);
-            node->right = rotateRight(node->right);
-            return rotateLeft(node);
+    void freeLayout() {
+        if (layoutPos) {
+            delete[] layoutPos;
+            delete[] layoutDisp;
+            mem.remove(layoutBytes(layoutN));
+            layoutPos = NULL;
+            layoutDisp = NULL;
         }
-
-        return node;
+        if (quadTree) {
+            delete quadTree;
+            quadTree = NULL;
+        }
+        freeEdgeList();
+        layoutN = 0;
     }
 
-    AVLNode* minValueNode(AVLNode* node) {
-        AVLNode* current = node;
-        while (current->left != NULL)
-            current = current->left;
-        return current;
+    // Starts from a circle with a little deterministic jitter, like the
+    // fixed layout the canvas used before
+    void initLayout() {
+        freeLayout();
+        layoutN = n;
+        layoutPos = new float[2 * n];
+        layoutDisp = new float[2 * n];
+        mem.add(layoutBytes(n));
+
+        float radius = 1.0f;
+        while (radius * radius < n) radius += 1.0f;
+        for (int i = 0; i < n; i++) {
+            float angle = 6.2831853f * i / (n > 0 ? n : 1);
+            float jitter = 0.05f * ((i * 7919) % 13) / 13.0f;
+            layoutPos[i] = (radius + jitter) * cosf(angle);
+            layoutPos[n + i] = (radius + jitter) * sinf(angle);
+        }
+        temperature = radius / 2;
     }
 
-    AVLNode* deleteNode(AVLNode* root, int val) {
-        if (root == NULL) 
-            return root;
-
-        if (val < root->data)
-            root->left = deleteNode(root->left, val);
-        else if (val > root->data)
-            root->right = deleteNode(root->right, val);
-        else {
-            if ((root->left == NULL) || (root->right == NULL)) {
-                AVLNode* temp = root->left ? root->left : root->right;
-                if (temp == NULL) {
-                    temp = root;
-                    root = NULL;
-                }
-                else {
-                    *root = *temp;
+    int logTarget() {
+        if (!opLog.owns(logId, logGeneration)) {
+            logId = opLog.newTarget(logGeneration);
+            opLog.record(OP_CREATE_GRAPH, logId, n, isDirected);
+            for (int i = 0; i < n; i++) {
+                for (int j = 0; j < n; j++) {
+                    if (adjMatrix[i][j] != 0)
+                        opLog.record(OP_GRAPH_ADD_EDGE, logId, i, j, adjMatrix[i][j]);
                 }
-                delete temp;
-            }
-            else {
-                AVLNode* temp = minValueNode(root->right);
-                root->data = temp->data;
-                root->right = deleteNode(root->right, temp->data);
             }
         }
+        return logId;
+    }
 
-        if (root == NULL) 
-            return root;
-
-        updateHeight(root);
-        int balance = getBalance(root);
+    static int matrixBytes(int vertices) {
+        return vertices * sizeof(int*) + vertices * vertices * sizeof(int);
+    }
 
-        if (balance > 1 && getBalance(root->left) >= 0)
-            return rotateRight(root);
+    int matrixBytes() {
+        return matrixBytes(n);
+    }
 
-        if (balance > 1 && getBalance(root->left) < 0) {
-            lastRotation = "Left-Right rotation (LR) on node " + intToString(root->data);
-            root->left = rotateLeft(root->left);
-            return rotateRight(root);
+    // Reallocates the matrix to exactly `vertices`, keeping the overlap
+    bool resizeMatrix(int vertices) {
+        if (vertices == n)
+            return true;
+        if (vertices > n && !memoryAvailable(matrixBytes(vertices) - matrixBytes()))
+            return false;
+
+        int** grown = new int* [vertices];
+        for (int i = 0; i < vertices; i++) {
+            grown[i] = new int[vertices];
+            for (int j = 0; j < vertices; j++) {
+                grown[i][j] = (i < n && j < n) ? adjMatrix[i][j] : 0;
+            }
         }
-
-        if (balance < -1 && getBalance(root->right) <= 0)
-            return rotateLeft(root);
-
-        if (balance < -1 && getBalance(root->right) > 0) {
-            lastRotation = "Right-Left rotation (RL) on node " + intToString(root->data);
-            root->right = rotateRight(root->right);
-            return rotateLeft(root);
+        for (int i = 0; i < n; i++) {
+            delete[] adjMatrix[i];
         }
+        delete[] adjMatrix;
 
-        return root;
+        mem.remove(matrixBytes());
+        adjMatrix = grown;
+        n = vertices;
+        mem.add(matrixBytes());
+        changes.markAll();
+        revision++;
+        return true;
     }
 
-    void inorderTraversal(AVLNode* node, string& result, bool& first) {
-        if (!node) 
-            return;
-        inorderTraversal(node->left, result, first);
-        if (!first) result += ",";
-        first = false;
-        result += intToString(node->data) + ":" +
-            intToString(node->height) + ":" +
-            intToString(getBalance(node));
-        inorderTraversal(node->right, result, first);
+    // Grows geometrically so edge lists do not reallocate per vertex;
+    // endImport() trims the slack.
+    bool ensureVertex(int vertex) {
+        if (vertex < n)
+            return true;
+        if (vertex >= MAX_IMPORT_VERTICES)
+            return false;
+        int target = n * 2;
+        if (target <= vertex) target = vertex + 1;
+        if (target > MAX_IMPORT_VERTICES) target = MAX_IMPORT_VERTICES;
+        return resizeMatrix(target) || resizeMatrix(vertex + 1);
     }
 
-public:
-    AVLTree() : root(NULL), lastRotation("No rotations performed") {}
+    // Fails on a missing or out-of-range number. An out-of-range number is
+    // left unconsumed, so callers can tell it apart from a missing one.
+    static bool readInt(const char*& p, const char* end, int& out) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+            p++;
+        const char* start = p;
+        bool negative = false;
+        if (p < end && *p == '-') {
+            negative = true;
+            p++;
+        }
+        if (p == end || *p < '0' || *p > '9')
+            return false;
+        int value = 0;
+        while (p < end && *p >= '0' && *p <= '9') {
+            int digit = *p - '0';
+            if (value > (INT_MAX - digit) / 10) {
+                p = start;
+                return false;
+            }
+            value = value * 10 + digit;
+            p++;
+        }
+        out = negative ? -value : value;
+        return true;
+    }
 
-    ~AVLTree() {}
+    // One parsed line of an import. Parsing touches no graph state, so
+    // the native loader can parse blocks on several threads and apply the
+    // lines in file order afterwards.
+    struct ImportLine {
+        char kind;  // 'p' header (u = declared vertices), 'a' arc, 'e' edge, 'x' malformed
+        int u, v, w;
+    };
+
+    // Accepts "u v [w]" edge lists (0-based) and DIMACS .gr lines:
+    // "c ..." comments, "p sp n m" header and "a u v w" arcs (1-based).
+    // Returns false for blank and comment lines.
+    static bool parseImportLine(const char* p, const char* end, ImportLine& line) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+            p++;
+        if (p == end || *p == 'c' || *p == '#' || *p == '%')
+            return false;
+
+        line.kind = 'x';
+        if (*p == 'p') {
+            p++;
+            while (p < end && (*p == ' ' || *p == '\t'))
+                p++;
+            while (p < end && *p != ' ' && *p != '\t')
+                p++;
+            if (readInt(p, end, line.u))
+                line.kind = 'p';
+            return true;
+        }
 
-    void insert(int val) {
-        lastRotation = "No rotations performed";
-        root = insertion(root, val);
+        bool arc = *p == 'a';
+        if (arc)
+            p++;
+        line.w = 1;
+        if (!readInt(p, end, line.u) || !readInt(p, end, line.v))
+            return true;
+        // The weight is optional, but a number too large to read is an error
+        if (!readInt(p, end, line.w) && p < end && (*p == '-' || (*p >= '0' && *p <= '9')))
+            return true;
+        line.kind = arc ? 'a' : 'e';
+        return true;
     }
 
-    void remove(int val) {
-        lastRotation = "No rotations performed";
-        root = deleteNode(root, val);
+    void importLine(const char* p, const char* end) {
+        ImportLine line;
+        if (parseImportLine(p, end, line))
+            applyImportLine(line);
     }
 
-    string getTree() {
-        string result = "[";
-        bool first = true;
-        inorderTraversal(root, result, first);
-        result += "]";
-        return result;
-    }
+    void applyImportLine(const ImportLine& line) {
+        if (line.kind == 'x') {
+            importRejected++;
+            return;
+        }
+        if (line.kind == 'p') {
+            int declared = line.u;
+            if (declared > MAX_IMPORT_VERTICES || !resizeMatrix(declared > n ? declared : n)) {
+                importRejected++;
+                return;
+            }
+            if (declared > importVertices)
+                importVertices = declared;
+            importOneBased = true;
+            return;
+        }
 
-    string getLastRotation() {
-        return lastRotation;
-    }
+        int u = line.u, v = line.v, w = line.w;
+        if (line.kind == 'a' || importOneBased) {
+            u--;
+            v--;
+        }
 
-    void clear() {
-        root = NULL;
-        lastRotation = "No rotations performed";
+        if (u < 0 || v < 0 || w == 0 || !ensureVertex(u > v ? u : v)) {
+            importRejected++;
+            return;
+        }
+        if (u + 1 > importVertices) importVertices = u + 1;
+        if (v + 1 > importVertices) importVertices = v + 1;
+
+        adjMatrix[u][v] = w;
+        if (!isDirected && u != v)
+            adjMatrix[v][u] = w;
+        importEdges++;
+        changes.markAll();
+        revision++;
     }
-};
-
-// ===================== 3. GRAPH (ADJACENCY MATRIX) =====================
-class Graph {
-private:
-    int n;
-    int** adjMatrix;
-    bool isDirected;
 
 public:
-    Graph(int vertices, bool directed = false) : n(vertices), isDirected(directed) {
+    Graph(int vertices, bool directed = false) : n(vertices), isDirected(directed), revision(0), mem(&graphMemory), trace(NULL),
+        importEdges(0), importRejected(0), importVertices(0), importOneBased(false),
+        logId(-1), logGeneration(0),
+        layoutN(0), layoutPos(NULL), layoutDisp(NULL), temperature(0), quadTree(NULL),
+        edgeList(NULL), edgeCount(0), edgeRevision(-1) {
         adjMatrix = new int* [n];
         for (int i = 0; i < n; i++) {
             adjMatrix[i] = new int[n];
@@ -545,17 +2860,28 @@ public:
                 adjMatrix[i][j] = 0;
             }
         }
+        mem.add(matrixBytes());
     }
 
     ~Graph() {
+        if (opLog.recording && opLog.owns(logId, logGeneration))
+            opLog.record(OP_DESTROY, logId);
+        disableTrace();
+        freeLayout();
         for (int i = 0; i < n; i++) {
             delete[] adjMatrix[i];
         }
         delete[] adjMatrix;
+        mem.remove(matrixBytes());
     }
 
     void addEdge(int u, int v, int w = 1) {
+        if (opLog.recording)
+            opLog.record(OP_GRAPH_ADD_EDGE, logTarget(), u, v, w);
         if (u >= 0 && u < n && v >= 0 && v < n) {
+            changes.add(u);
+            changes.add(v);
+            revision++;
             adjMatrix[u][v] = w;
             if (!isDirected && u != v) {
                 adjMatrix[v][u] = w;
@@ -564,7 +2890,12 @@ public:
     }
 
     void removeEdge(int u, int v) {
+        if (opLog.recording)
+            opLog.record(OP_GRAPH_REMOVE_EDGE, logTarget(), u, v);
         if (u >= 0 && u < n && v >= 0 && v < n) {
+            changes.add(u);
+            changes.add(v);
+            revision++;
             adjMatrix[u][v] = 0;
             if (!isDirected) {
                 adjMatrix[v][u] = 0;
@@ -573,7 +2904,11 @@ public:
     }
 
     void setDirected(bool directed) {
+        if (opLog.recording)
+            opLog.record(OP_GRAPH_SET_DIRECTED, logTarget(), directed);
         isDirected = directed;
+        changes.markAll();
+        revision++;
         if (!directed) {
             for (int i = 0; i < n; i++) {
                 for (int j = i + 1; j < n; j++) {
@@ -591,11 +2926,22 @@ public:
         return isDirected;
     }
 
+    // 0 when there is no edge u -> v or either vertex is out of range
+    int getWeight(int u, int v) {
+        if (u < 0 || u >= n || v < 0 || v >= n)
+            return 0;
+        return adjMatrix[u][v];
+    }
+
+    // Always returns a fresh graph owned by the caller, so JS can delete the
+    // old handle unconditionally without freeing the result.
     Graph* removeVertex(int vertex) {
-        if (vertex < 0 || vertex >= n) 
-            return this;
+        if (opLog.recording)
+            opLog.record(OP_GRAPH_REMOVE_VERTEX, logTarget(), vertex);
+        if (vertex < 0 || vertex >= n)
+            vertex = -1;
 
-        Graph* newGraph = new Graph(n - 1, isDirected);
+        Graph* newGraph = new Graph(vertex == -1 ? n : n - 1, isDirected);
 
         int newI = 0;
         for (int i = 0; i < n; i++) {
@@ -609,9 +2955,7 @@ public:
                     continue;
                 }
 
-                if (adjMatrix[i][j] != 0) {
-                    newGraph->addEdge(newI, newJ, adjMatrix[i][j]);
-                }
+                newGraph->adjMatrix[newI][newJ] = adjMatrix[i][j];
                 newJ++;
             }
             newI++;
@@ -621,6 +2965,8 @@ public:
     }
 
     string getMatrix() {
+        if (opLog.recording)
+            opLog.record(OP_GRAPH_GET_MATRIX, logTarget());
         string result = "[";
         for (int i = 0; i < n; i++) {
             result += "[";
@@ -636,6 +2982,8 @@ public:
     }
 
     string bfs(int start) {
+        if (opLog.recording)
+            opLog.record(OP_GRAPH_BFS, logTarget(), start);
         if (start < 0 || start >= n) 
             return "[]";
 
@@ -645,6 +2993,8 @@ public:
         Queue q;
         visited[start] = true;
         q.enqueue(start);
+        if (trace)
+            trace->record(TRACE_ENQUEUE, start, -1);
 
         string result = "[";
         bool first = true;
@@ -656,11 +3006,15 @@ public:
             if (!first) result += ",";
             first = false;
             result += intToString(node);
+            if (trace)
+                trace->record(TRACE_VISIT, node);
 
             for (int neighbor = 0; neighbor < n; neighbor++) {
                 if (adjMatrix[node][neighbor] != 0 && !visited[neighbor]) {
                     visited[neighbor] = true;
                     q.enqueue(neighbor);
+                    if (trace)
+                        trace->record(TRACE_ENQUEUE, neighbor, node);
                 }
             }
         }
@@ -671,6 +3025,8 @@ public:
     }
 
     string dfs(int start) {
+        if (opLog.recording)
+            opLog.record(OP_GRAPH_DFS, logTarget(), start);
         if (start < 0 || start >= n) 
             return "[]";
 
@@ -679,6 +3035,8 @@ public:
 
         Stack s;
         s.push(start);
+        if (trace)
+            trace->record(TRACE_ENQUEUE, start, -1);
 
         string result = "[";
         bool first = true;
@@ -693,10 +3051,14 @@ public:
                 if (!first) result += ",";
                 first = false;
                 result += intToString(node);
+                if (trace)
+                    trace->record(TRACE_VISIT, node);
 
                 for (int neighbor = n - 1; neighbor >= 0; neighbor--) {
                     if (adjMatrix[node][neighbor] != 0 && !visited[neighbor]) {
                         s.push(neighbor);
+                        if (trace)
+                            trace->record(TRACE_ENQUEUE, neighbor, node);
                     }
                 }
             }
@@ -708,6 +3070,8 @@ public:
     }
 
     string dijkstra(int start) {
+        if (opLog.recording)
+            opLog.record(OP_GRAPH_DIJKSTRA, logTarget(), start);
         if (start < 0 || start >= n) 
             return "[]";
 
@@ -729,6 +3093,8 @@ public:
 
             if (visited[u]) continue;
             visited[u] = true;
+            if (trace)
+                trace->record(TRACE_SETTLE, u, dist[u]);
 
             for (int v = 0; v < n; v++) {
                 if (adjMatrix[u][v] != 0 && !visited[v]) {
@@ -736,6 +3102,8 @@ public:
                     if (dist[u] + weight < dist[v]) {
                         dist[v] = dist[u] + weight;
                         pq.push(v, dist[v]);
+                        if (trace)
+                            trace->record(TRACE_RELAX, u, v, dist[v]);
                     }
                 }
             }
@@ -754,6 +3122,8 @@ public:
     }
 
     string primMST() {
+        if (opLog.recording)
+            opLog.record(OP_GRAPH_PRIM, logTarget());
         if (isDirected) {
             return "[]";
         }
@@ -781,6 +3151,8 @@ public:
 
             if (inMST[u]) continue;
             inMST[u] = true;
+            if (trace)
+                trace->record(TRACE_SETTLE, u, key[u], parent[u]);
 
             if (parent[u] != -1) {
                 if (!first) result += ",";
@@ -795,6 +3167,8 @@ public:
                     key[v] = adjMatrix[u][v];
                     parent[v] = u;
                     pq.push(v, key[v]);
+                    if (trace)
+                        trace->record(TRACE_RELAX, u, v, key[v]);
                 }
             }
         }
@@ -808,6 +3182,10 @@ public:
     }
 
     void clear() {
+        if (opLog.recording)
+            opLog.record(OP_GRAPH_CLEAR, logTarget());
+        changes.markAll();
+        revision++;
         for (int i = 0; i < n; i++) {
             for (int j = 0; j < n; j++) {
                 adjMatrix[i][j] = 0;
@@ -818,6 +3196,393 @@ public:
     int getVertexCount() {
         return n;
     }
+
+    int getRevision() {
+        return revision;
+    }
+
+#ifdef __EMSCRIPTEN__
+    // Copies the matrix row by row into an Int32Array of n * n weights, so
+    // it can be transferred to the worker without building a string
+    void copyWeights(val out) {
+        for (int i = 0; i < n; i++)
+            out.call<void>("set", val(typed_memory_view(n, adjMatrix[i])), i * n);
+    }
+
+    // Replaces the matrix with a copyWeights() snapshot of `vertices` rows
+    bool loadWeights(val weights, int vertices) {
+        if (vertices < 0 || weights["length"].as<int>() != vertices * vertices || !resizeMatrix(vertices))
+            return false;
+        for (int i = 0; i < n; i++)
+            val(typed_memory_view(n, adjMatrix[i])).call<void>("set", weights.call<val>("subarray", i * n, (i + 1) * n));
+        changes.markAll();
+        revision++;
+        // Not expressible as ops; re-create from the result
+        if (opLog.recording && opLog.owns(logId, logGeneration))
+            opLog.record(OP_DESTROY, logId);
+        logId = -1;
+        return true;
+    }
+#endif
+
+    // Streaming import: call importChunk() with consecutive pieces of the
+    // file (lines may span chunks), then endImport(). Only the unfinished
+    // last line of a chunk is buffered.
+    void beginImport() {
+        importCarry = "";
+        importEdges = 0;
+        importRejected = 0;
+        importVertices = n;
+        importOneBased = false;
+    }
+
+    int importChunk(const string& chunk) {
+        const char* p = chunk.c_str();
+        const char* end = p + chunk.size();
+
+        if (!importCarry.empty()) {
+            const char* newline = p;
+            while (newline < end && *newline != '\n')
+                newline++;
+            importCarry.append(p, newline - p);
+            if (newline == end)
+                return importEdges;
+            importLine(importCarry.c_str(), importCarry.c_str() + importCarry.size());
+            importCarry = "";
+            p = newline + 1;
+        }
+
+        const char* lineStart = p;
+        while (p < end) {
+            if (*p == '\n') {
+                importLine(lineStart, p);
+                lineStart = p + 1;
+            }
+            p++;
+        }
+        importCarry.assign(lineStart, end - lineStart);
+        return importEdges;
+    }
+
+    // Returns "[edges,rejected]"
+    string endImport() {
+        if (!importCarry.empty()) {
+            importLine(importCarry.c_str(), importCarry.c_str() + importCarry.size());
+            importCarry = "";
+        }
+        if (importVertices < n)
+            resizeMatrix(importVertices);
+        // The import is not expressible as ops; re-create from the result
+        if (opLog.recording && opLog.owns(logId, logGeneration))
+            opLog.record(OP_DESTROY, logId);
+        logId = -1;
+        return "[" + intToString(importEdges) + "," + intToString(importRejected) + "]";
+    }
+
+#ifndef __EMSCRIPTEN__
+    // Native import of a whole file, mapped rather than read so the text
+    // is never copied. Text files are split into blocks at line breaks and
+    // parsed on `threads` threads (0 = one per core); the parsed lines are
+    // then applied in file order, so the result matches importChunk().
+    // Files starting with "CSR1" are binary CSR instead: int32 n, m,
+    // offsets[n + 1], targets[m], weights[m]. Returns "[edges,rejected]",
+    // or "[-1,0]" when the file cannot be mapped or the scratch space does
+    // not fit in the memory budget.
+    string importFile(const char* path, int threads) {
+        int fd = open(path, O_RDONLY);
+        if (fd < 0)
+            return "[-1,0]";
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            close(fd);
+            return "[-1,0]";
+        }
+        size_t size = info.st_size;
+        const char* data = NULL;
+        if (size > 0) {
+            void* mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED) {
+                data = (const char*)mapped;
+                madvise(mapped, size, MADV_SEQUENTIAL);
+            }
+        }
+        close(fd);
+        if (size > 0 && !data)
+            return "[-1,0]";
+
+        beginImport();
+        bool loaded = size >= 4 && memcmp(data, "CSR1", 4) == 0
+            ? importCSR((const int*)data, size)
+            : importText(data, size, threads > 0 ? threads : (int)thread::hardware_concurrency());
+        if (data)
+            munmap((void*)data, size);
+        string result = endImport();
+        return loaded ? result : "[-1,0]";
+    }
+
+private:
+    static const int IMPORT_BLOCK_BYTES = 1 << 20;
+
+    // Each thread parses at most one block per round into its own buffer;
+    // a parsed line needs at least two bytes, which bounds the buffer
+    static void parseImportBlock(const char* p, const char* end, ImportLine* lines, int* count) {
+        int parsed = 0;
+        const char* lineStart = p;
+        while (p < end) {
+            if (*p == '\n') {
+                if (parseImportLine(lineStart, p, lines[parsed]))
+                    parsed++;
+                lineStart = p + 1;
+            }
+            p++;
+        }
+        if (lineStart < end && parseImportLine(lineStart, end, lines[parsed]))
+            parsed++;
+        *count = parsed;
+    }
+
+    bool importText(const char* data, size_t size, int threads) {
+        if (threads < 1) threads = 1;
+        if (threads > 64) threads = 64;
+        // Blocks are extended to the next line break, so leave room for one
+        // long line past the nominal block size
+        int capacity = IMPORT_BLOCK_BYTES / 2 + 2;
+        int scratchBytes = threads * capacity * sizeof(ImportLine);
+        if (!memoryAvailable(scratchBytes))
+            return false;
+        mem.add(scratchBytes);
+        ImportLine** lines = new ImportLine* [threads];
+        int* counts = new int[threads];
+        for (int t = 0; t < threads; t++)
+            lines[t] = new ImportLine[capacity];
+
+        const char* p = data;
+        const char* end = data + size;
+        thread* workers = new thread[threads];
+        const char* blockStart[64];
+        const char* blockEnd[64];
+        while (p < end) {
+            int blocks = 0;
+            while (blocks < threads && p < end) {
+                const char* stop = end - p > IMPORT_BLOCK_BYTES ? p + IMPORT_BLOCK_BYTES : end;
+                while (stop < end && stop[-1] != '\n')
+                    stop++;
+                // A line longer than the spare capacity is parsed on its own
+                if ((stop - p) / 2 + 1 > capacity) {
+                    stop = p;
+                    while (stop < end && *stop != '\n')
+                        stop++;
+                    if (stop < end) stop++;
+                }
+                blockStart[blocks] = p;
+                blockEnd[blocks] = stop;
+                blocks++;
+                p = stop;
+            }
+            for (int t = 1; t < blocks; t++)
+                workers[t] = thread(parseImportBlock, blockStart[t], blockEnd[t], lines[t], counts + t);
+            parseImportBlock(blockStart[0], blockEnd[0], lines[0], counts);
+            for (int t = 1; t < blocks; t++)
+                workers[t].join();
+            for (int t = 0; t < blocks; t++)
+                for (int i = 0; i < counts[t]; i++)
+                    applyImportLine(lines[t][i]);
+        }
+
+        delete[] workers;
+        for (int t = 0; t < threads; t++)
+            delete[] lines[t];
+        delete[] lines;
+        delete[] counts;
+        mem.remove(scratchBytes);
+        return true;
+    }
+
+    // The CSR arrays are read in place from the mapping; edges with a zero
+    // weight or an out-of-range target are rejected
+    bool importCSR(const int* data, size_t size) {
+        if (size < 3 * sizeof(int)) {
+            importRejected++;
+            return true;
+        }
+        long long vertices = data[1], edges = data[2];
+        if (vertices < 0 || edges < 0 || vertices > MAX_IMPORT_VERTICES ||
+            (long long)size != (3 + vertices + 1 + 2 * edges) * (long long)sizeof(int)) {
+            importRejected++;
+            return true;
+        }
+        const int* offsets = data + 3;
+        const int* targets = offsets + vertices + 1;
+        const int* weights = targets + edges;
+        if (offsets[0] != 0 || offsets[vertices] != edges) {
+            importRejected++;
+            return true;
+        }
+        for (int u = 0; u < vertices; u++) {
+            if (offsets[u + 1] < offsets[u] || offsets[u + 1] > edges) {
+                importRejected++;
+                return true;
+            }
+        }
+        if (!resizeMatrix(vertices > n ? vertices : n))
+            return false;
+        if (vertices > importVertices)
+            importVertices = vertices;
+
+        for (int u = 0; u < vertices; u++) {
+            for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+                int v = targets[e], w = weights[e];
+                if (v < 0 || v >= vertices || w == 0) {
+                    importRejected++;
+                    continue;
+                }
+                adjMatrix[u][v] = w;
+                if (!isDirected && u != v)
+                    adjMatrix[v][u] = w;
+                importEdges++;
+            }
+        }
+        changes.markAll();
+        revision++;
+        return true;
+    }
+
+public:
+#endif
+
+    // Advances the Fruchterman-Reingold layout by `iterations` steps, using
+    // the Barnes-Hut quadtree for repulsion. Returns true while vertices
+    // are still moving noticeably. Edge changes reheat the layout.
+    bool layoutStep(int iterations) {
+        if (opLog.recording)
+            opLog.record(OP_GRAPH_LAYOUT_STEP, logTarget(), iterations);
+        if (n == 0)
+            return false;
+        if (layoutN != n) {
+            if (!memoryAvailable(layoutBytes(n)))
+                return false;
+            initLayout();
+        }
+        if (!quadTree) {
+            if (!memoryAvailable(QuadTree::bytesFor(QuadTree::INITIAL_CELLS)))
+                return false;
+            quadTree = new QuadTree(&mem);
+        }
+        bool edgesChanged = edgeRevision != revision;
+        if (!syncEdgeList())
+            return false;
+
+        float* x = layoutPos;
+        float* y = layoutPos + n;
+        float* dx = layoutDisp;
+        float* dy = layoutDisp + n;
+        const float k = 1.0f;
+        const float theta = 0.8f;
+        const float gravity = 0.05f;
+        const float minTemperature = 0.002f;
+
+        if (edgesChanged) {
+            float reheat = sqrtf((float)n) / 4;
+            if (temperature < reheat) temperature = reheat;
+        }
+
+        for (int it = 0; it < iterations && temperature > minTemperature; it++) {
+            if (it == 0)
+                changes.markAll();
+            if (!quadTree->build(x, y, n))
+                return false;
+
+            for (int i = 0; i < n; i++) {
+                float fx = -gravity * x[i];
+                float fy = -gravity * y[i];
+                quadTree->repulse(i, x[i], y[i], k * k, theta, fx, fy);
+                dx[i] = fx;
+                dy[i] = fy;
+            }
+
+            for (int m = 0; m < edgeCount; m++) {
+                int u = edgeList[2 * m];
+                int v = edgeList[2 * m + 1];
+                float ex = x[u] - x[v];
+                float ey = y[u] - y[v];
+                float d = sqrtf(ex * ex + ey * ey);
+                float f = d / k;
+                dx[u] -= ex * f;
+                dy[u] -= ey * f;
+                dx[v] += ex * f;
+                dy[v] += ey * f;
+            }
+
+            for (int i = 0; i < n; i++) {
+                float len = sqrtf(dx[i] * dx[i] + dy[i] * dy[i]);
+                if (len > 0) {
+                    float step = len < temperature ? len : temperature;
+                    x[i] += dx[i] / len * step;
+                    y[i] += dy[i] / len * step;
+                }
+            }
+            temperature *= 0.97f;
+        }
+
+        return temperature > minTemperature;
+    }
+
+    void resetLayout() {
+        freeLayout();
+    }
+
+#ifdef __EMSCRIPTEN__
+    // Float32Array [x0..xn-1, y0..yn-1]; empty until layoutStep() runs
+    val getLayout() {
+        return val(typed_memory_view(layoutPos ? 2 * layoutN : 0, layoutPos));
+    }
+#endif
+
+#ifdef __EMSCRIPTEN__
+    val getChanges() {
+        return changes.view();
+    }
+#endif
+
+    void resetChanges() {
+        changes.reset();
+    }
+
+    string getMemoryStats() {
+        return "[" + mem.toString() + "]";
+    }
+
+    bool enableTrace(int capacity) {
+        disableTrace();
+        if (capacity <= 0 || capacity > TraceLog::MAX_CAPACITY || !memoryAvailable(TraceLog::bytesFor(capacity)))
+            return false;
+        trace = new TraceLog(capacity);
+        mem.add(trace->bytes());
+        return true;
+    }
+
+    void disableTrace() {
+        if (trace) {
+            mem.remove(trace->bytes());
+            delete trace;
+            trace = NULL;
+        }
+    }
+
+    void clearTrace() {
+        if (trace)
+            trace->clear();
+    }
+
+#ifdef __EMSCRIPTEN__
+    val getTrace() {
+        return trace ? trace->view() : val(typed_memory_view(0, (int*)NULL));
+    }
+#endif
+
+    int getTraceDropped() {
+        return trace ? trace->getDropped() : 0;
+    }
 };
 
 // ===================== 4. HASH TABLE (CHAINING) =====================
@@ -833,6 +3598,39 @@ class HashTable {
 private:
     static const int TABLE_SIZE = 10;
     HashNode** table;
+    MemoryStats mem;
+    int logId;
+    int logGeneration;
+    ChangeSet changes;
+
+    int logTarget() {
+        if (!opLog.owns(logId, logGeneration)) {
+            logId = opLog.newTarget(logGeneration);
+            opLog.record(OP_CREATE_HASH, logId);
+            // insert() pushes at the head, so each chain is recorded
+            // tail-first for the replay to rebuild it in the same order
+            for (int i = 0; i < TABLE_SIZE; i++)
+                logChain(table[i]);
+        }
+        return logId;
+    }
+
+    void logChain(HashNode* head) {
+        int length = 0;
+        for (HashNode* node = head; node; node = node->next)
+            length++;
+        if (length == 0)
+            return;
+        HashNode** chain = new HashNode* [length];
+        int i = 0;
+        for (HashNode* node = head; node; node = node->next)
+            chain[i++] = node;
+        while (i > 0) {
+            i--;
+            opLog.record(OP_HASH_INSERT, logId, chain[i]->key, chain[i]->value);
+        }
+        delete[] chain;
+    }
 
     int abs(int x) { return x < 0 ? -x : x; }
 
@@ -840,44 +3638,72 @@ private:
         return abs(key) % TABLE_SIZE;
     }
 
+    void appendBucket(string& result, int index) {
+        result += "[";
+        bool first = true;
+        for (HashNode* current = table[index]; current; current = current->next) {
+            if (!first) result += ",";
+            first = false;
+            result += intToString(current->key) + ":" +
+                intToString(current->value);
+        }
+        result += "]";
+    }
+
 public:
-    HashTable() {
+    HashTable() : mem(&hashMemory), logId(-1), logGeneration(0) {
         table = new HashNode * [TABLE_SIZE];
         for (int i = 0; i < TABLE_SIZE; i++) {
             table[i] = NULL;
         }
+        mem.add(TABLE_SIZE * sizeof(HashNode*));
     }
 
     ~HashTable() {
+        if (opLog.recording && opLog.owns(logId, logGeneration))
+            opLog.record(OP_DESTROY, logId);
         for (int i = 0; i < TABLE_SIZE; i++) {
             HashNode* current = table[i];
             while (current) {
                 HashNode* temp = current;
                 current = current->next;
                 delete temp;
+                mem.remove(sizeof(HashNode));
             }
         }
         delete[] table;
+        mem.remove(TABLE_SIZE * sizeof(HashNode*));
     }
 
-    void insert(int key, int value) {
+    bool insert(int key, int value) {
+        if (opLog.recording)
+            opLog.record(OP_HASH_INSERT, logTarget(), key, value);
         int index = hashFunction(key);
 
         HashNode* current = table[index];
         while (current) {
             if (current->key == key) {
                 current->value = value;
-                return;
+                changes.add(index);
+                return true;
             }
             current = current->next;
         }
 
+        if (!memoryAvailable(sizeof(HashNode)))
+            return false;
+
         HashNode* newNode = new HashNode(key, value);
+        mem.add(sizeof(HashNode));
         newNode->next = table[index];
         table[index] = newNode;
+        changes.add(index);
+        return true;
     }
 
     int search(int key) {
+        if (opLog.recording)
+            opLog.record(OP_HASH_SEARCH, logTarget(), key);
         int index = hashFunction(key);
 
         HashNode* current = table[index];
@@ -892,22 +3718,12 @@ public:
     }
 
     string getTable() {
+        if (opLog.recording)
+            opLog.record(OP_HASH_GET_TABLE, logTarget());
         string result = "[";
 
         for (int i = 0; i < TABLE_SIZE; i++) {
-            result += "[";
-
-            HashNode* current = table[i];
-            bool first = true;
-            while (current) {
-                if (!first) result += ",";
-                first = false;
-                result += intToString(current->key) + ":" +
-                    intToString(current->value);
-                current = current->next;
-            }
-
-            result += "]";
+            appendBucket(result, i);
             if (i < TABLE_SIZE - 1) result += ",";
         }
 
@@ -915,30 +3731,326 @@ public:
         return result;
     }
 
+    int getBucketCount() {
+        return TABLE_SIZE;
+    }
+
+    // One bucket of getTable(), e.g. "[12:5,2:7]"; "[]" when out of range
+    string getBucket(int index) {
+        string result;
+        if (index < 0 || index >= TABLE_SIZE)
+            return "[]";
+        appendBucket(result, index);
+        return result;
+    }
+
     void clear() {
+        if (opLog.recording)
+            opLog.record(OP_HASH_CLEAR, logTarget());
+        changes.markAll();
         for (int i = 0; i < TABLE_SIZE; i++) {
             HashNode* current = table[i];
             while (current) {
                 HashNode* temp = current;
                 current = current->next;
                 delete temp;
+                mem.remove(sizeof(HashNode));
             }
             table[i] = NULL;
         }
     }
+
+#ifdef __EMSCRIPTEN__
+    val getChanges() {
+        return changes.view();
+    }
+#endif
+
+    void resetChanges() {
+        changes.reset();
+    }
+
+    string getMemoryStats() {
+        return "[" + mem.toString() + "]";
+    }
+};
+
+// ===================== OPCODE DISPATCH =====================
+// Executes one record on its target and returns its int result: 1/0 for
+// success, the value for extract/search, or the string length for
+// getters and algorithms. CREATE/DESTROY are handled by the caller.
+int runOpcode(int op, void* target, const int* args) {
+    switch (op) {
+    case OP_HEAP_INSERT:
+        return ((BinaryHeap*)target)->insert(args[0]) ? 1 : 0;
+    case OP_HEAP_EXTRACT:
+        return ((BinaryHeap*)target)->extractTop();
+    case OP_HEAP_CLEAR:
+        ((BinaryHeap*)target)->clear();
+        return 1;
+    case OP_HEAP_CONVERT:
+        if (args[0])
+            ((BinaryHeap*)target)->convertToMinHeap();
+        else
+            ((BinaryHeap*)target)->convertToMaxHeap();
+        return 1;
+    case OP_HEAP_GET_ARRAY:
+        return ((BinaryHeap*)target)->getArray().size();
+    case OP_HEAP_SET_BOUND:
+        return ((BinaryHeap*)target)->setBound(args[0]) ? 1 : 0;
+    case OP_HEAP_DRAIN:
+        return ((BinaryHeap*)target)->drain();
+    case OP_AVL_INSERT:
+        return ((AVLTree*)target)->insert(args[0]) ? 1 : 0;
+    case OP_AVL_REMOVE:
+        ((AVLTree*)target)->remove(args[0]);
+        return 1;
+    case OP_AVL_CLEAR:
+        ((AVLTree*)target)->clear();
+        return 1;
+    case OP_AVL_GET_TREE:
+        return ((AVLTree*)target)->getTree().size();
+    case OP_AVL_CONTAINS:
+        return ((AVLTree*)target)->contains(args[0]) ? 1 : 0;
+    case OP_GRAPH_ADD_EDGE:
+        ((Graph*)target)->addEdge(args[0], args[1], args[2]);
+        return 1;
+    case OP_GRAPH_REMOVE_EDGE:
+        ((Graph*)target)->removeEdge(args[0], args[1]);
+        return 1;
+    case OP_GRAPH_CLEAR:
+        ((Graph*)target)->clear();
+        return 1;
+    case OP_GRAPH_SET_DIRECTED:
+        ((Graph*)target)->setDirected(args[0] != 0);
+        return 1;
+    case OP_GRAPH_GET_MATRIX:
+        return ((Graph*)target)->getMatrix().size();
+    case OP_GRAPH_BFS:
+        return ((Graph*)target)->bfs(args[0]).size();
+    case OP_GRAPH_DFS:
+        return ((Graph*)target)->dfs(args[0]).size();
+    case OP_GRAPH_DIJKSTRA:
+        return ((Graph*)target)->dijkstra(args[0]).size();
+    case OP_GRAPH_PRIM:
+        return ((Graph*)target)->primMST().size();
+    case OP_GRAPH_LAYOUT_STEP:
+        return ((Graph*)target)->layoutStep(args[0]) ? 1 : 0;
+    case OP_GRAPH_REMOVE_VERTEX:
+        // The caller keeps using the old graph's target; the result is
+        // only built for its cost.
+        delete ((Graph*)target)->removeVertex(args[0]);
+        return 1;
+    case OP_HASH_INSERT:
+        return ((HashTable*)target)->insert(args[0], args[1]) ? 1 : 0;
+    case OP_HASH_SEARCH:
+        return ((HashTable*)target)->search(args[0]);
+    case OP_HASH_CLEAR:
+        ((HashTable*)target)->clear();
+        return 1;
+    case OP_HASH_GET_TABLE:
+        return ((HashTable*)target)->getTable().size();
+    }
+    return 0;
+}
+
+// ===================== COMMAND BUFFER =====================
+// Runs many operations per call. JS writes commands into getCommands() as
+// [op, target, args...] and calls execute(length); each command writes one
+// int to getResults() as returned by runOpcode(). Log-only opcodes
+// (REMOVE_VERTEX, CREATE_*, DESTROY) are rejected.
+class CommandBuffer {
+private:
+    static const int MAX_TARGETS = 16;
+
+    int* commands;
+    int* results;
+    int capacity;
+    int resultCount;
+
+    TargetType targetTypes[MAX_TARGETS];
+    void* targets[MAX_TARGETS];
+    int targetCount;
+
+    // Reuses the first unbound slot before growing
+    int bindTarget(TargetType type, void* target) {
+        if (target == NULL)
+            return -1;
+        int slot = 0;
+        while (slot < targetCount && targetTypes[slot] != TARGET_NONE)
+            slot++;
+        if (slot == MAX_TARGETS)
+            return -1;
+        targetTypes[slot] = type;
+        targets[slot] = target;
+        if (slot == targetCount)
+            targetCount++;
+        return slot;
+    }
+
+    int bytes() {
+        return 2 * capacity * sizeof(int);
+    }
+
+public:
+    // Largest capacity whose two arrays still fit in an int of bytes
+    static const int MAX_CAPACITY = INT_MAX / (2 * sizeof(int));
+
+    // A non-positive or oversized capacity, or one the memory budget
+    // refuses, leaves the buffer empty: getCapacity() is 0 and execute()
+    // runs nothing
+    CommandBuffer(int cap) : commands(NULL), results(NULL), capacity(0), resultCount(0), targetCount(0) {
+        if (cap > 0 && cap <= MAX_CAPACITY && memoryAvailable(2 * cap * sizeof(int))) {
+            capacity = cap;
+            commands = new int[capacity];
+            results = new int[capacity];
+            commandMemory.add(bytes());
+        }
+        for (int i = 0; i < MAX_TARGETS; i++) {
+            targetTypes[i] = TARGET_NONE;
+            targets[i] = NULL;
+        }
+    }
+
+    ~CommandBuffer() {
+        delete[] commands;
+        delete[] results;
+        commandMemory.remove(bytes());
+    }
+
+    int bindHeap(BinaryHeap* heap) {
+        return bindTarget(TARGET_HEAP, heap);
+    }
+
+    int bindTree(AVLTree* tree) {
+        return bindTarget(TARGET_AVL, tree);
+    }
+
+    int bindGraph(Graph* graph) {
+        return bindTarget(TARGET_GRAPH, graph);
+    }
+
+    int bindHashTable(HashTable* table) {
+        return bindTarget(TARGET_HASH, table);
+    }
+
+    // Call before deleting a bound structure; execute() rejects commands
+    // for unbound slots
+    bool unbind(int target) {
+        if (target < 0 || target >= targetCount || targetTypes[target] == TARGET_NONE)
+            return false;
+        targetTypes[target] = TARGET_NONE;
+        targets[target] = NULL;
+        return true;
+    }
+
+    // Graphs are replaced on removeVertex, so their slot can be rebound
+    bool rebindGraph(int target, Graph* graph) {
+        if (target < 0 || target >= targetCount || targetTypes[target] != TARGET_GRAPH || graph == NULL)
+            return false;
+        targets[target] = graph;
+        return true;
+    }
+
+    // Runs commands[0..length). Stops at the first malformed command and
+    // returns the number of commands executed.
+    int execute(int length) {
+        if (length > capacity)
+            length = capacity;
+
+        resultCount = 0;
+        int pc = 0;
+        while (pc < length) {
+            int op = commands[pc];
+            int operands = opOperands(op);
+            if (operands < 0 || opLogOnly(op) || pc + 1 + operands > length)
+                break;
+
+            int target = commands[pc + 1];
+            if (target < 0 || target >= targetCount || targets[target] == NULL || targetTypes[target] != opTargetType(op))
+                break;
+
+            results[resultCount++] = runOpcode(op, targets[target], commands + pc + 2);
+            pc += 1 + operands;
+        }
+        return resultCount;
+    }
+
+#ifdef __EMSCRIPTEN__
+    val getCommands() {
+        return val(typed_memory_view(capacity, commands));
+    }
+
+    val getResults() {
+        return val(typed_memory_view(resultCount, results));
+    }
+#endif
+
+    int getCapacity() {
+        return capacity;
+    }
 };
 
 // ===================== EMSCRIPTEN BINDINGS =====================
+#ifdef __EMSCRIPTEN__
 EMSCRIPTEN_BINDINGS(data_structures) {
     class_<BinaryHeap>("BinaryHeap")
         .constructor<bool>()
         .function("insert", &BinaryHeap::insert)
         .function("extractTop", &BinaryHeap::extractTop)
         .function("getArray", &BinaryHeap::getArray)
+        .function("getSize", &BinaryHeap::getSize)
+        .function("getSlot", &BinaryHeap::getSlot)
         .function("clear", &BinaryHeap::clear)
         .function("convertToMinHeap", &BinaryHeap::convertToMinHeap)
         .function("convertToMaxHeap", &BinaryHeap::convertToMaxHeap)
-        .function("getIsMinHeap", &BinaryHeap::getIsMinHeap);
+        .function("getIsMinHeap", &BinaryHeap::getIsMinHeap)
+        .function("setBound", &BinaryHeap::setBound)
+        .function("getBound", &BinaryHeap::getBound)
+        .function("pushStream", &BinaryHeap::pushStream)
+        .function("drain", &BinaryHeap::drain)
+        .function("drainTopK", &BinaryHeap::drainTopK)
+        .function("getMemoryStats", &BinaryHeap::getMemoryStats)
+        .function("getChanges", &BinaryHeap::getChanges)
+        .function("resetChanges", &BinaryHeap::resetChanges)
+        .function("enableTrace", &BinaryHeap::enableTrace)
+        .function("disableTrace", &BinaryHeap::disableTrace)
+        .function("clearTrace", &BinaryHeap::clearTrace)
+        .function("getTrace", &BinaryHeap::getTrace)
+        .function("getTraceDropped", &BinaryHeap::getTraceDropped);
+
+    class_<PersistentHeap>("PersistentHeap")
+        .constructor<bool>()
+        .function("insert", &PersistentHeap::insert)
+        .function("extractTop", &PersistentHeap::extractTop)
+        .function("getTop", &PersistentHeap::getTop)
+        .function("getSize", &PersistentHeap::getSize)
+        .function("getArray", &PersistentHeap::getArray)
+        .function("clear", &PersistentHeap::clear)
+        .function("getIsMinHeap", &PersistentHeap::getIsMinHeap)
+        .function("snapshot", &PersistentHeap::snapshot)
+        .function("restore", &PersistentHeap::restore)
+        .function("releaseVersion", &PersistentHeap::releaseVersion)
+        .function("getVersionCount", &PersistentHeap::getVersionCount)
+        .function("getMemoryStats", &PersistentHeap::getMemoryStats);
+
+    class_<AddressableHeap>("AddressableHeap")
+        .constructor<bool>()
+        .function("insert", &AddressableHeap::insert)
+        .function("extractTop", &AddressableHeap::extractTop)
+        .function("getTop", &AddressableHeap::getTop)
+        .function("getTopHandle", &AddressableHeap::getTopHandle)
+        .function("decreaseKey", &AddressableHeap::decreaseKey)
+        .function("increaseKey", &AddressableHeap::increaseKey)
+        .function("erase", &AddressableHeap::erase)
+        .function("contains", &AddressableHeap::contains)
+        .function("getValue", &AddressableHeap::getValue)
+        .function("meld", &AddressableHeap::meld, allow_raw_pointers())
+        .function("getSize", &AddressableHeap::getSize)
+        .function("getArray", &AddressableHeap::getArray)
+        .function("clear", &AddressableHeap::clear)
+        .function("getIsMinHeap", &AddressableHeap::getIsMinHeap)
+        .function("getMemoryStats", &AddressableHeap::getMemoryStats);
 
     class_<AVLTree>("AVLTree")
         .constructor<>()
@@ -946,7 +4058,29 @@ EMSCRIPTEN_BINDINGS(data_structures) {
         .function("remove", &AVLTree::remove)
         .function("getTree", &AVLTree::getTree)
         .function("clear", &AVLTree::clear)
-        .function("getLastRotation", &AVLTree::getLastRotation);
+        .function("getLastRotation", &AVLTree::getLastRotation)
+        .function("getRotationHistory", &AVLTree::getRotationHistory)
+        .function("contains", &AVLTree::contains)
+        .function("freeze", &AVLTree::freeze, allow_raw_pointers())
+        .function("snapshot", &AVLTree::snapshot)
+        .function("restore", &AVLTree::restore)
+        .function("releaseVersion", &AVLTree::releaseVersion)
+        .function("getVersionCount", &AVLTree::getVersionCount)
+        .function("getMemoryStats", &AVLTree::getMemoryStats)
+        .function("getChanges", &AVLTree::getChanges)
+        .function("resetChanges", &AVLTree::resetChanges)
+        .function("enableTrace", &AVLTree::enableTrace)
+        .function("disableTrace", &AVLTree::disableTrace)
+        .function("clearTrace", &AVLTree::clearTrace)
+        .function("getTrace", &AVLTree::getTrace)
+        .function("getTraceDropped", &AVLTree::getTraceDropped);
+
+    class_<FrozenIndex>("FrozenIndex")
+        .function("lowerBound", &FrozenIndex::lowerBound)
+        .function("contains", &FrozenIndex::contains)
+        .function("findMany", &FrozenIndex::findMany)
+        .function("getSize", &FrozenIndex::getSize)
+        .function("getMemoryStats", &FrozenIndex::getMemoryStats);
 
     class_<Graph>("Graph")
         .constructor<int, bool>()
@@ -954,6 +4088,7 @@ EMSCRIPTEN_BINDINGS(data_structures) {
         .function("removeEdge", &Graph::removeEdge)
         .function("setDirected", &Graph::setDirected)
         .function("getIsDirected", &Graph::getIsDirected)
+        .function("getWeight", &Graph::getWeight)
         .function("removeVertex", &Graph::removeVertex, allow_raw_pointers())
         .function("getMatrix", &Graph::getMatrix)
         .function("bfs", &Graph::bfs)
@@ -961,12 +4096,57 @@ EMSCRIPTEN_BINDINGS(data_structures) {
         .function("dijkstra", &Graph::dijkstra)
         .function("primMST", &Graph::primMST)
         .function("clear", &Graph::clear)
-        .function("getVertexCount", &Graph::getVertexCount);
+        .function("getVertexCount", &Graph::getVertexCount)
+        .function("getRevision", &Graph::getRevision)
+        .function("copyWeights", &Graph::copyWeights)
+        .function("loadWeights", &Graph::loadWeights)
+        .function("beginImport", &Graph::beginImport)
+        .function("importChunk", &Graph::importChunk)
+        .function("endImport", &Graph::endImport)
+        .function("layoutStep", &Graph::layoutStep)
+        .function("resetLayout", &Graph::resetLayout)
+        .function("getLayout", &Graph::getLayout)
+        .function("getMemoryStats", &Graph::getMemoryStats)
+        .function("getChanges", &Graph::getChanges)
+        .function("resetChanges", &Graph::resetChanges)
+        .function("enableTrace", &Graph::enableTrace)
+        .function("disableTrace", &Graph::disableTrace)
+        .function("clearTrace", &Graph::clearTrace)
+        .function("getTrace", &Graph::getTrace)
+        .function("getTraceDropped", &Graph::getTraceDropped);
 
     class_<HashTable>("HashTable")
         .constructor<>()
         .function("insert", &HashTable::insert)
         .function("search", &HashTable::search)
         .function("getTable", &HashTable::getTable)
-        .function("clear", &HashTable::clear);
-}
\ No newline at end of file
+        .function("getBucketCount", &HashTable::getBucketCount)
+        .function("getBucket", &HashTable::getBucket)
+        .function("clear", &HashTable::clear)
+        .function("getMemoryStats", &HashTable::getMemoryStats)
+        .function("getChanges", &HashTable::getChanges)
+        .function("resetChanges", &HashTable::resetChanges);
+
+    class_<CommandBuffer>("CommandBuffer")
+        .constructor<int>()
+        .function("bindHeap", &CommandBuffer::bindHeap, allow_raw_pointers())
+        .function("bindTree", &CommandBuffer::bindTree, allow_raw_pointers())
+        .function("bindGraph", &CommandBuffer::bindGraph, allow_raw_pointers())
+        .function("bindHashTable", &CommandBuffer::bindHashTable, allow_raw_pointers())
+        .function("rebindGraph", &CommandBuffer::rebindGraph, allow_raw_pointers())
+        .function("unbind", &CommandBuffer::unbind)
+        .function("execute", &CommandBuffer::execute)
+        .function("getCommands", &CommandBuffer::getCommands)
+        .function("getResults", &CommandBuffer::getResults)
+        .function("getCapacity", &CommandBuffer::getCapacity);
+
+    emscripten::function("startRecording", &startRecording);
+    emscripten::function("stopRecording", &stopRecording);
+    emscripten::function("getRecording", &getRecording);
+    emscripten::function("isRecordingTruncated", &isRecordingTruncated);
+
+    emscripten::function("memoryReport", &memoryReport);
+    emscripten::function("setMemoryBudget", &setMemoryBudget);
+    emscripten::function("getMemoryBudget", &getMemoryBudget);
+}
+#endif
\ No newline at end of file
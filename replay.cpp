@@ -0,0 +1,209 @@
+// Native replay of an operation log recorded in the browser with
+// Module.startRecording() / Module.getRecording() (saved as raw int32).
+// Re-executes every record against the C++ classes and prints a latency
+// histogram per operation, so slow sessions become reproducible benchmarks.
+//
+//   g++ -O2 -g -std=c++17 replay.cpp -o replay
+//   ./replay session.oplog [iterations]
+//   perf record -g ./replay session.oplog 100
+#include "data_structures.cpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+// ===================== LATENCY HISTOGRAM =====================
+// Bucket b counts operations that took [2^b, 2^(b+1)) nanoseconds
+struct OpStats {
+    static const int BUCKETS = 40;
+
+    long long count;
+    long long totalNs;
+    long long maxNs;
+    long long buckets[BUCKETS];
+
+    OpStats() : count(0), totalNs(0), maxNs(0) {
+        for (int i = 0; i < BUCKETS; i++) buckets[i] = 0;
+    }
+
+    void add(long long ns) {
+        count++;
+        totalNs += ns;
+        if (ns > maxNs) maxNs = ns;
+        int b = 0;
+        while (b < BUCKETS - 1 && (1LL << (b + 1)) <= ns) b++;
+        buckets[b]++;
+    }
+
+    // Upper bound of the bucket holding the given percentile
+    long long percentile(double p) {
+        long long rank = (long long)(count * p);
+        long long seen = 0;
+        for (int b = 0; b < BUCKETS; b++) {
+            seen += buckets[b];
+            if (seen > rank) return (1LL << (b + 1)) < maxNs ? (1LL << (b + 1)) : maxNs;
+        }
+        return maxNs;
+    }
+};
+
+const char* opName(int op) {
+    static const char* names[OP_COUNT] = {
+        "?", "heap.insert", "heap.extractTop", "heap.clear",
+        "avl.insert", "avl.remove", "avl.clear",
+        "graph.addEdge", "graph.removeEdge", "graph.clear",
+        "hash.insert", "hash.search", "hash.clear",
+        "heap.convert", "heap.getArray", "avl.getTree",
+        "graph.setDirected", "graph.getMatrix", "graph.bfs", "graph.dfs",
+        "graph.dijkstra", "graph.primMST", "hash.getTable",
+        "graph.removeVertex", "create.heap", "create.avl", "create.graph",
+        "create.hash", "destroy", "heap.setBound", "heap.drain",
+        "avl.contains", "graph.layoutStep"
+    };
+    return (op > 0 && op < OP_COUNT) ? names[op] : "?";
+}
+
+// ===================== REPLAY =====================
+class Replayer {
+private:
+    void** targets;
+    TargetType* types;
+    int targetCount;
+
+    void destroy(int id) {
+        switch (types[id]) {
+        case TARGET_HEAP: delete (BinaryHeap*)targets[id]; break;
+        case TARGET_AVL: delete (AVLTree*)targets[id]; break;
+        case TARGET_GRAPH: delete (Graph*)targets[id]; break;
+        case TARGET_HASH: delete (HashTable*)targets[id]; break;
+        case TARGET_NONE: break;
+        }
+        targets[id] = NULL;
+        types[id] = TARGET_NONE;
+    }
+
+public:
+    OpStats stats[OP_COUNT];
+    long long skipped;
+
+    Replayer(int maxTarget) : targetCount(maxTarget + 1), skipped(0) {
+        targets = new void* [targetCount];
+        types = new TargetType[targetCount];
+        for (int i = 0; i < targetCount; i++) {
+            targets[i] = NULL;
+            types[i] = TARGET_NONE;
+        }
+    }
+
+    ~Replayer() {
+        reset();
+        delete[] targets;
+        delete[] types;
+    }
+
+    void reset() {
+        for (int i = 0; i < targetCount; i++) destroy(i);
+    }
+
+    // Runs one record and returns its timing in nanoseconds, or -1 if skipped
+    long long run(int op, int id, const int* args) {
+        if (id < 0 || id >= targetCount) return -1;
+
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        switch (op) {
+        case OP_CREATE_HEAP:
+            destroy(id);
+            targets[id] = new BinaryHeap(args[0] != 0);
+            types[id] = TARGET_HEAP;
+            break;
+        case OP_CREATE_AVL:
+            destroy(id);
+            targets[id] = new AVLTree();
+            types[id] = TARGET_AVL;
+            break;
+        case OP_CREATE_GRAPH:
+            destroy(id);
+            targets[id] = new Graph(args[0], args[1] != 0);
+            types[id] = TARGET_GRAPH;
+            break;
+        case OP_CREATE_HASH:
+            destroy(id);
+            targets[id] = new HashTable();
+            types[id] = TARGET_HASH;
+            break;
+        case OP_DESTROY:
+            destroy(id);
+            break;
+        default:
+            if (types[id] != opTargetType(op)) return -1;
+            runOpcode(op, targets[id], args);
+        }
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+    }
+};
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <oplog> [iterations]\n", argv[0]);
+        return 1;
+    }
+    int iterations = argc > 2 ? atoi(argv[2]) : 1;
+    if (iterations < 1) iterations = 1;
+
+    FILE* file = fopen(argv[1], "rb");
+    if (!file) {
+        fprintf(stderr, "cannot open %s\n", argv[1]);
+        return 1;
+    }
+    fseek(file, 0, SEEK_END);
+    long bytes = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    int length = bytes / sizeof(int);
+    int* log = new int[length > 0 ? length : 1];
+    if (fread(log, sizeof(int), length, file) != (size_t)length) {
+        fprintf(stderr, "short read on %s\n", argv[1]);
+        fclose(file);
+        return 1;
+    }
+    fclose(file);
+
+    // Validate the stream once and size the target table
+    int maxTarget = -1;
+    int records = 0;
+    for (int pc = 0; pc < length; records++) {
+        int operands = opOperands(log[pc]);
+        if (operands < 0 || pc + 1 + operands > length) {
+            fprintf(stderr, "malformed record at int %d (op %d)\n", pc, log[pc]);
+            length = pc;
+            break;
+        }
+        if (log[pc + 1] > maxTarget) maxTarget = log[pc + 1];
+        pc += 1 + operands;
+    }
+
+    Replayer replayer(maxTarget);
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (int it = 0; it < iterations; it++) {
+        for (int pc = 0; pc < length; pc += 1 + opOperands(log[pc])) {
+            long long ns = replayer.run(log[pc], log[pc + 1], log + pc + 2);
+            if (ns < 0)
+                replayer.skipped++;
+            else
+                replayer.stats[log[pc]].add(ns);
+        }
+        replayer.reset();
+    }
+    double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+    printf("%d records x %d iterations in %.2f ms (%lld skipped)\n\n", records, iterations, wallMs, replayer.skipped);
+    printf("%-20s %10s %12s %10s %10s %10s %10s\n", "operation", "count", "total ms", "mean ns", "p50 ns", "p99 ns", "max ns");
+    for (int op = 1; op < OP_COUNT; op++) {
+        OpStats& st = replayer.stats[op];
+        if (st.count == 0) continue;
+        printf("%-20s %10lld %12.3f %10lld %10lld %10lld %10lld\n", opName(op), st.count,
+            st.totalNs / 1e6, st.totalNs / st.count, st.percentile(0.5), st.percentile(0.99), st.maxNs);
+    }
+
+    delete[] log;
+    return 0;
+}
@@ -0,0 +1,98 @@
+// Background worker that runs heavy data structure operations off the UI thread.
+// It owns a separate instance of the WebAssembly module and keeps a mirror
+// of the graph, which the page reloads (as a transferred Int32Array) only
+// when the graph changed since the last request. Graph runs are traced and
+// their events sent back (also transferred) to drive the page's animation.
+var Module = {
+    onRuntimeInitialized: function() {
+        workerReady = true;
+        self.postMessage({ ready: true });
+        pendingMessages.forEach(handleMessage);
+        pendingMessages = [];
+    },
+    // e.g. data_structures.wasm failed to load; the page falls back to the main thread
+    onAbort: function(reason) {
+        self.postMessage({ failed: String(reason) });
+    }
+};
+
+let workerReady = false;
+let pendingMessages = [];
+let mirrorGraph = null;
+
+importScripts('data_structures.js');
+
+self.onmessage = function(event) {
+    if (!workerReady) {
+        pendingMessages.push(event.data);
+        return;
+    }
+    handleMessage(event.data);
+};
+
+function handleMessage(message) {
+    try {
+        let result;
+        const transfer = [];
+        switch (message.op) {
+            case 'graphAlgorithm':
+                result = runGraphAlgorithm(message.args);
+                if (result.trace) transfer.push(result.trace.buffer);
+                break;
+            default:
+                throw new Error(`Unknown worker operation: ${message.op}`);
+        }
+        self.postMessage({ id: message.id, result: result }, transfer);
+    } catch (error) {
+        self.postMessage({ id: message.id, error: error.message });
+    }
+}
+
+// Trace events kept per run, matching GRAPH_TRACE_CAPACITY in app.js
+const GRAPH_TRACE_CAPACITY = 4096;
+
+// Runs one of bfs/dfs/dijkstra/primMST, first reloading the mirror graph
+// if the request carries new weights. Returns { result, trace } where trace
+// is null if the run overflowed the trace capacity.
+function runGraphAlgorithm(args) {
+    if (args.weights) {
+        if (mirrorGraph) {
+            mirrorGraph.delete();
+            mirrorGraph = null;
+        }
+        const g = new Module.Graph(0, args.directed);
+        if (!g.loadWeights(args.weights, args.vertices)) {
+            g.delete();
+            throw new Error('Graph does not fit in the worker memory budget');
+        }
+        mirrorGraph = g;
+    }
+    if (!mirrorGraph) {
+        throw new Error('Worker graph is not loaded');
+    }
+    
+    const traced = mirrorGraph.enableTrace ? mirrorGraph.enableTrace(GRAPH_TRACE_CAPACITY) : false;
+    try {
+        let result;
+        switch (args.algorithm) {
+            case 'bfs':
+                result = mirrorGraph.bfs(args.start);
+                break;
+            case 'dfs':
+                result = mirrorGraph.dfs(args.start);
+                break;
+            case 'dijkstra':
+                result = mirrorGraph.dijkstra(args.start);
+                break;
+            case 'prim':
+                result = mirrorGraph.primMST();
+                break;
+            default:
+                throw new Error(`Unknown graph algorithm: ${args.algorithm}`);
+        }
+        const trace = traced && mirrorGraph.getTraceDropped() === 0 ? mirrorGraph.getTrace().slice() : null;
+        return { result, trace };
+    } finally {
+        if (traced) mirrorGraph.disableTrace();
+    }
+}